@@ -7,10 +7,111 @@
 #include <cassert>
 #include <cmath>
 #include <initializer_list>
+#include <type_traits>
+#include <utility>
 
 namespace mini {
 namespace algebra {
 
+template <class Value, int kSize>
+class Column;
+
+// Expression templates, which fuse chained operations into a single loop:
+template <class Value, int kSize, class Operation, class Left, class Right>
+class Binary;
+template <class Value, int kSize, class Operation, class Operand>
+class Scaled;
+
+template <class T>
+struct Traits {
+  static constexpr bool kIsColumn = false;
+  static constexpr bool kIsExpression = false;
+};
+template <class V, int N>
+struct Traits<Column<V, N>> {
+  using Value = V;
+  static constexpr int kSize = N;
+  static constexpr bool kIsColumn = true;
+  static constexpr bool kIsExpression = false;
+};
+template <class V, int N, class Operation, class Left, class Right>
+struct Traits<Binary<V, N, Operation, Left, Right>> {
+  using Value = V;
+  static constexpr int kSize = N;
+  static constexpr bool kIsColumn = false;
+  static constexpr bool kIsExpression = true;
+};
+template <class V, int N, class Operation, class Operand>
+struct Traits<Scaled<V, N, Operation, Operand>> {
+  using Value = V;
+  static constexpr int kSize = N;
+  static constexpr bool kIsColumn = false;
+  static constexpr bool kIsExpression = true;
+};
+// Either a `Column` (but not a class derived from it) or an expression of it:
+template <class T>
+constexpr bool IsOperand() {
+  using U = std::decay_t<T>;
+  return Traits<U>::kIsColumn || Traits<U>::kIsExpression;
+}
+template <class T>
+constexpr bool IsExpression() {
+  return Traits<std::decay_t<T>>::kIsExpression;
+}
+// Hold lvalue `Column`s by reference, temporaries and expressions by value:
+template <class T>
+using Stored = std::conditional_t<
+    std::is_lvalue_reference_v<T> && Traits<std::decay_t<T>>::kIsColumn,
+    std::decay_t<T> const&, std::decay_t<T>>;
+
+struct Plus {
+  template <class X, class Y>
+  static auto Apply(X const& x, Y const& y) { return x + y; }
+};
+struct Minus {
+  template <class X, class Y>
+  static auto Apply(X const& x, Y const& y) { return x - y; }
+};
+struct Times {
+  template <class X, class Y>
+  static auto Apply(X const& x, Y const& y) { return x * y; }
+};
+struct Divide {
+  template <class X, class Y>
+  static auto Apply(X const& x, Y const& y) { return x / y; }
+};
+
+template <class Value, int kSize, class Operation, class Left, class Right>
+class Binary {
+ public:
+  template <class L, class R>
+  Binary(L&& left, R&& right)
+      : left_(std::forward<L>(left)), right_(std::forward<R>(right)) {}
+  Value operator[](int i) const {
+    return Operation::Apply(left_[i], right_[i]);
+  }
+  static constexpr int size() { return kSize; }
+
+ private:
+  Left left_;
+  Right right_;
+};
+template <class Value, int kSize, class Operation, class Operand>
+class Scaled {
+ public:
+  template <class O>
+  Scaled(O&& operand, Value const& scalar)
+      : operand_(std::forward<O>(operand)), scalar_(scalar) {}
+  Value operator[](int i) const {
+    return Operation::Apply(operand_[i], scalar_);
+  }
+  static constexpr int size() { return kSize; }
+
+ private:
+  Operand operand_;
+  Value scalar_;
+};
+
 template <class Value, int kSize>
 class Column : public std::array<Value, kSize> {
  public:
@@ -19,90 +120,126 @@ class Column : public std::array<Value, kSize> {
   template <class Iterator>
   Column(Iterator first, Iterator last) {
     assert(last - first <= kSize);
-    std::uninitialized_copy(first, last, this->begin());
+    std::fill(std::copy(first, last, this->begin()), this->end(), Value{});
   }
   Column(std::initializer_list<Value> init)
       : Column(init.begin(), init.end()) {}
+  template <class Expression,
+            class = std::enable_if_t<IsExpression<Expression>()>>
+  Column(Expression const& expression) {  // NOLINT(runtime/explicit)
+    Assign(expression);
+  }
+  template <class Expression,
+            class = std::enable_if_t<IsExpression<Expression>()>>
+  Column& operator=(Expression const& expression) {
+    return Assign(expression);
+  }
   // Arithmetic operators:
-  Column& operator+=(Column const& rhs) {
-    return ForEachPair(rhs, [](Value& x, Value const& y){ x += y; });
+  template <class That, class = std::enable_if_t<IsOperand<That>()>>
+  Column& operator+=(That const& that) {
+    for (int i = 0; i != kSize; ++i) { (*this)[i] += that[i]; }
+    return *this;
+  }
+  template <class That, class = std::enable_if_t<IsOperand<That>()>>
+  Column& operator-=(That const& that) {
+    for (int i = 0; i != kSize; ++i) { (*this)[i] -= that[i]; }
+    return *this;
   }
-  Column& operator-=(Column const& rhs) {
-    return ForEachPair(rhs, [](Value& x, Value const& y){ x -= y; });
+  Column& operator+=(Column const& that) {
+    for (int i = 0; i != kSize; ++i) { (*this)[i] += that[i]; }
+    return *this;
+  }
+  Column& operator-=(Column const& that) {
+    for (int i = 0; i != kSize; ++i) { (*this)[i] -= that[i]; }
+    return *this;
   }
   Column& operator*=(Value const& rhs) {
-    for (int i = 0; i != this->size(); ++i) {
-      this->at(i) *= rhs;
-    }
+    for (int i = 0; i != kSize; ++i) { (*this)[i] *= rhs; }
     return *this;
   }
   Column& operator/=(Value const& rhs) {
-    assert(rhs != 0);
-    for (auto i = 0; i != this->size(); ++i) {
-      this->at(i) /= rhs;
-    }
+    assert(rhs != Value{});
+    for (int i = 0; i != kSize; ++i) { (*this)[i] /= rhs; }
     return *this;
   }
   Value Dot(const Column& that) const {
     Value dot{0};
-    for (auto i = 0; i != kSize; ++i) {
-      dot += this->at(i) * that[i];
+    for (int i = 0; i != kSize; ++i) {
+      dot += (*this)[i] * that[i];
+    }
+    return dot;
+  }
+  // Evaluate an expression in the same loop, rather than into a temporary:
+  template <class That, class = std::enable_if_t<IsExpression<That>()>>
+  Value Dot(That const& that) const {
+    static_assert(Traits<That>::kSize == kSize);
+    Value dot{0};
+    for (int i = 0; i != kSize; ++i) {
+      dot += (*this)[i] * that[i];
     }
     return dot;
   }
 
  private:
-  template <class Operation>
-  Column& ForEachPair(Column const& that, Operation&& operation) {
-    assert(this->size() == that.size());
-    auto this_head = this->begin(), tail = this->end();
-    auto that_head = that.begin();
-    for (; this_head != tail; ++this_head, ++that_head) {
-      operation(*this_head, *that_head);
-    }
+  template <class Expression>
+  Column& Assign(Expression const& expression) {
+    static_assert(Traits<Expression>::kSize == kSize);
+    for (int i = 0; i != kSize; ++i) { (*this)[i] = expression[i]; }
     return *this;
   }
 };
-// Binary operators:
-template <class Value, int kSize>
-Column<Value, kSize> operator+(
-    Column<Value, kSize> const& lhs,
-    Column<Value, kSize> const& rhs) {
-  auto v = lhs;
-  v += rhs;
-  return v;
+// Binary operators, which return unevaluated expressions:
+template <class L, class R,
+          class = std::enable_if_t<IsOperand<L>() && IsOperand<R>()>>
+auto operator+(L&& lhs, R&& rhs) {
+  using T = Traits<std::decay_t<L>>;
+  static_assert(T::kSize == Traits<std::decay_t<R>>::kSize);
+  return Binary<typename T::Value, T::kSize, Plus, Stored<L>, Stored<R>>(
+      std::forward<L>(lhs), std::forward<R>(rhs));
 }
-template <class Value, int kSize>
-Column<Value, kSize> operator-(
-    Column<Value, kSize> const& lhs,
-    Column<Value, kSize> const& rhs) {
-  auto v = lhs;
-  v -= rhs;
-  return v;
+template <class L, class R,
+          class = std::enable_if_t<IsOperand<L>() && IsOperand<R>()>>
+auto operator-(L&& lhs, R&& rhs) {
+  using T = Traits<std::decay_t<L>>;
+  static_assert(T::kSize == Traits<std::decay_t<R>>::kSize);
+  return Binary<typename T::Value, T::kSize, Minus, Stored<L>, Stored<R>>(
+      std::forward<L>(lhs), std::forward<R>(rhs));
 }
-template <class Value, int kSize>
-Column<Value, kSize> operator*(
-    Value const& lhs,
-    Column<Value, kSize> const& rhs) {
-  auto v = rhs;
-  v *= lhs;
-  return v;
+template <class L, class = std::enable_if_t<IsOperand<L>()>>
+auto operator*(L&& lhs, typename Traits<std::decay_t<L>>::Value const& rhs) {
+  using T = Traits<std::decay_t<L>>;
+  return Scaled<typename T::Value, T::kSize, Times, Stored<L>>(
+      std::forward<L>(lhs), rhs);
 }
-template <class Value, int kSize>
-Column<Value, kSize> operator*(
-    Column<Value, kSize> const& lhs,
-    Value const& rhs) {
-  auto v = lhs;
-  v *= rhs;
-  return v;
+template <class R, class = std::enable_if_t<IsOperand<R>()>>
+auto operator*(typename Traits<std::decay_t<R>>::Value const& lhs, R&& rhs) {
+  using T = Traits<std::decay_t<R>>;
+  return Scaled<typename T::Value, T::kSize, Times, Stored<R>>(
+      std::forward<R>(rhs), lhs);
 }
-template <class Value, int kSize>
-Column<Value, kSize> operator/(
-    Column<Value, kSize> const& lhs,
-    Value const& rhs) {
-  auto v = lhs;
-  v /= rhs;
-  return v;
+template <class L, class = std::enable_if_t<IsOperand<L>()>>
+auto operator/(L&& lhs, typename Traits<std::decay_t<L>>::Value const& rhs) {
+  assert(rhs != 0);
+  using T = Traits<std::decay_t<L>>;
+  return Scaled<typename T::Value, T::kSize, Divide, Stored<L>>(
+      std::forward<L>(lhs), rhs);
+}
+// Comparisons involving at least one expression:
+template <class L, class R, class = std::enable_if_t<
+    IsOperand<L>() && IsOperand<R>() &&
+    (IsExpression<L>() || IsExpression<R>())>>
+bool operator==(L const& lhs, R const& rhs) {
+  static_assert(Traits<L>::kSize == Traits<R>::kSize);
+  for (int i = 0; i != Traits<L>::kSize; ++i) {
+    if (lhs[i] != rhs[i]) { return false; }
+  }
+  return true;
+}
+template <class L, class R, class = std::enable_if_t<
+    IsOperand<L>() && IsOperand<R>() &&
+    (IsExpression<L>() || IsExpression<R>())>>
+bool operator!=(L const& lhs, R const& rhs) {
+  return !(lhs == rhs);
 }
 
 }  // namespace algebra
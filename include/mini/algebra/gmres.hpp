@@ -0,0 +1,129 @@
+//  Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_ALGEBRA_GMRES_HPP_
+#define MINI_ALGEBRA_GMRES_HPP_
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+namespace mini {
+namespace algebra {
+
+// Restarted GMRES with right preconditioning, which only touches the matrix
+// `A` and the preconditioner `M` (approximating `inv(A)`) through their
+// products with vectors, so `A` may be matrix-free.
+template <class Value>
+class Gmres {
+ public:
+  // Types:
+  using Vector = std::vector<Value>;
+  // Constructors:
+  Gmres() = default;
+  Gmres(int n_restart, int max_iterations, Value tolerance)
+      : n_restart_(n_restart), max_iterations_(max_iterations),
+        tolerance_(tolerance) {
+    assert(n_restart > 0 && max_iterations > 0 && tolerance > 0);
+  }
+  // Accessors:
+  int CountIterations() const { return n_iterations_; }
+  // Relative to the norm of `b`:
+  Value GetResidual() const { return residual_; }
+  // Solve A * x = b, from the initial guess in `x`, until the residual
+  // drops below `tolerance` times the norm of `b`.  The products are given
+  // by `a(v, &y)` for y = A * v and `m(v, &y)` for y = M * v.  Return true
+  // if converged:
+  template <class A, class M>
+  bool Solve(A&& a, M&& m, Vector const& b, Vector* x) {
+    int n = b.size();
+    assert(static_cast<int>(x->size()) == n);
+    auto b_norm = Norm(b);
+    n_iterations_ = 0;
+    residual_ = 0;
+    if (b_norm == 0) {
+      x->assign(n, Value{0});
+      return true;
+    }
+    auto basis = std::vector<Vector>(n_restart_ + 1, Vector(n));
+    auto h = std::vector<Vector>(n_restart_ + 1, Vector(n_restart_));
+    auto cos = Vector(n_restart_), sin = Vector(n_restart_);
+    auto g = Vector(n_restart_ + 1);
+    auto z = Vector(n), w = Vector(n);
+    while (n_iterations_ < max_iterations_) {
+      // r = b - A * x
+      a(*x, &w);
+      auto& r = basis[0];
+      for (int i = 0; i != n; ++i) { r[i] = b[i] - w[i]; }
+      auto beta = Norm(r);
+      residual_ = beta / b_norm;
+      if (residual_ <= tolerance_) { return true; }
+      Scale(1 / beta, &r);
+      g.assign(n_restart_ + 1, Value{0});
+      g[0] = beta;
+      int j = 0;
+      while (j != n_restart_ && n_iterations_ != max_iterations_) {
+        ++n_iterations_;
+        // Arnoldi by modified Gram-Schmidt on w = A * M * v_j:
+        m(basis[j], &z);
+        a(z, &w);
+        for (int i = 0; i <= j; ++i) {
+          h[i][j] = Dot(w, basis[i]);
+          for (int k = 0; k != n; ++k) { w[k] -= h[i][j] * basis[i][k]; }
+        }
+        h[j + 1][j] = Norm(w);
+        basis[j + 1] = w;
+        if (h[j + 1][j] != 0) { Scale(1 / h[j + 1][j], &basis[j + 1]); }
+        // Keep H upper triangular by Givens rotations:
+        for (int i = 0; i != j; ++i) {
+          auto temp = cos[i] * h[i][j] + sin[i] * h[i + 1][j];
+          h[i + 1][j] = cos[i] * h[i + 1][j] - sin[i] * h[i][j];
+          h[i][j] = temp;
+        }
+        auto rho = std::hypot(h[j][j], h[j + 1][j]);
+        cos[j] = h[j][j] / rho;
+        sin[j] = h[j + 1][j] / rho;
+        h[j][j] = rho;
+        h[j + 1][j] = 0;
+        g[j + 1] = -sin[j] * g[j];
+        g[j] *= cos[j];
+        ++j;
+        residual_ = std::abs(g[j]) / b_norm;
+        if (residual_ <= tolerance_) { break; }
+      }
+      // x += M * (V * y), where H * y = g:
+      for (int i = j - 1; i >= 0; --i) {
+        for (int k = i + 1; k != j; ++k) { g[i] -= h[i][k] * g[k]; }
+        g[i] /= h[i][i];
+      }
+      w.assign(n, Value{0});
+      for (int i = 0; i != j; ++i) {
+        for (int k = 0; k != n; ++k) { w[k] += g[i] * basis[i][k]; }
+      }
+      m(w, &z);
+      for (int k = 0; k != n; ++k) { (*x)[k] += z[k]; }
+      if (residual_ <= tolerance_) { return true; }
+    }
+    return false;
+  }
+
+ private:
+  static Value Dot(Vector const& u, Vector const& v) {
+    Value dot{0};
+    int n = u.size();
+    for (int i = 0; i != n; ++i) { dot += u[i] * v[i]; }
+    return dot;
+  }
+  static Value Norm(Vector const& v) { return std::sqrt(Dot(v, v)); }
+  static void Scale(Value s, Vector* v) {
+    for (auto& v_i : *v) { v_i *= s; }
+  }
+  int n_restart_{30};
+  int max_iterations_{100};
+  Value tolerance_{1e-3};
+  int n_iterations_{0};
+  Value residual_{0};
+};
+
+}  // namespace algebra
+}  // namespace mini
+
+#endif  //  MINI_ALGEBRA_GMRES_HPP_
@@ -0,0 +1,89 @@
+//  Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_ALGEBRA_LU_HPP_
+#define MINI_ALGEBRA_LU_HPP_
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+#include "mini/algebra/column.hpp"
+#include "mini/algebra/matrix.hpp"
+#include "mini/algebra/unroll.hpp"
+
+namespace mini {
+namespace algebra {
+
+// LU factorization (with partial pivoting) of a small dense matrix, whose
+// size is known at compile time, so all loops are fully unrolled:
+template <class Value, int kSize>
+class Lu {
+ public:
+  // Types:
+  using Matrix = algebra::Matrix<Value, kSize, kSize>;
+  using Column = algebra::Column<Value, kSize>;
+  // Constructors:
+  Lu() = default;
+  explicit Lu(Matrix const& a) : lu_(a) {
+    Unroll<kSize>([&](auto k_) {
+      constexpr int k = decltype(k_)::value;
+      int pivot = k;
+      Unroll<kSize>([&](auto r) {
+        if constexpr (r > k) {
+          if (std::abs(lu_[r][k]) > std::abs(lu_[pivot][k])) { pivot = r; }
+        }
+      });
+      assert(lu_[pivot][k] != Value{0});
+      std::swap(lu_[k], lu_[pivot]);
+      permutation_[k] = pivot;
+      Unroll<kSize>([&](auto r) {
+        if constexpr (r > k) {
+          auto l = lu_[r][k] /= lu_[k][k];
+          Unroll<kSize>([&](auto c) {
+            if constexpr (c > k) { lu_[r][c] -= l * lu_[k][c]; }
+          });
+        }
+      });
+    });
+  }
+  // Solve A * x = b:
+  Column Solve(Column b) const {
+    Unroll<kSize>([&](auto k) { std::swap(b[k], b[permutation_[k]]); });
+    // Forward substitution by the unit lower triangle:
+    Unroll<kSize>([&](auto r_) {
+      constexpr int r = decltype(r_)::value;
+      Unroll<kSize>([&](auto c) {
+        if constexpr (c < r) { b[r] -= lu_[r][c] * b[c]; }
+      });
+    });
+    // Backward substitution by the upper triangle:
+    Unroll<kSize>([&](auto i) {
+      constexpr int r = kSize - 1 - decltype(i)::value;
+      Unroll<kSize>([&](auto c) {
+        if constexpr (c > r) { b[r] -= lu_[r][c] * b[c]; }
+      });
+      b[r] /= lu_[r][r];
+    });
+    return b;
+  }
+  // Get inv(A), which is cheaper to apply than Solve() if used many times:
+  Matrix Inverse() const {
+    Matrix inverse;
+    Unroll<kSize>([&](auto c) {
+      auto unit = Column{};
+      unit[c] = 1;
+      auto x = Solve(unit);
+      Unroll<kSize>([&](auto r) { inverse[r][c] = x[r]; });
+    });
+    return inverse;
+  }
+
+ private:
+  Matrix lu_;  // unit lower and upper triangles
+  std::array<int, kSize> permutation_;  // row k was swapped with this one
+};
+
+}  // namespace algebra
+}  // namespace mini
+
+#endif  //  MINI_ALGEBRA_LU_HPP_
@@ -4,6 +4,7 @@
 
 #include "mini/algebra/column.hpp"
 #include "mini/algebra/row.hpp"
+#include "mini/algebra/unroll.hpp"
 
 namespace mini {
 namespace algebra {
@@ -19,10 +20,13 @@ class Matrix : public Column<Row<Value, kColumns>, kRows> {
 template <class Value, int kRows, int kColumns>
 Column<Value, kRows> operator*(
     Matrix<Value, kRows, kColumns> const& matrix,
-    Column<Value, kRows> const& column) {
+    Column<Value, kColumns> const& column) {
   Column<Value, kRows> product;
   for (int r = 0; r != kRows; ++r) {
-    product[r] = matrix[r] * column;
+    auto& row = matrix[r];
+    Value dot{0};
+    for (int c = 0; c != kColumns; ++c) { dot += row[c] * column[c]; }
+    product[r] = dot;
   }
   return product;
 }
@@ -30,13 +34,30 @@ template <class Value, int kRows, int kColumns>
 Matrix<Value, kRows, kColumns> operator*(
     Matrix<Value, kRows, kColumns> const& matrix,
     Value const& value) {
-  auto product = matrix;
-  for (auto& row : product) {
-    row *= value;
+  Matrix<Value, kRows, kColumns> product;
+  for (int r = 0; r != kRows; ++r) {
+    for (int c = 0; c != kColumns; ++c) {
+      product[r][c] = matrix[r][c] * value;
+    }
   }
   return product;
 }
 
+template <class Value, int kRows, int kMiddle, int kColumns>
+Matrix<Value, kRows, kColumns> operator*(
+    Matrix<Value, kRows, kMiddle> const& left,
+    Matrix<Value, kMiddle, kColumns> const& right) {
+  Matrix<Value, kRows, kColumns> product;
+  Unroll<kRows>([&](auto r) {
+    Unroll<kColumns>([&](auto c) {
+      Value dot{0};
+      Unroll<kMiddle>([&](auto k) { dot += left[r][k] * right[k][c]; });
+      product[r][c] = dot;
+    });
+  });
+  return product;
+}
+
 }  // namespace algebra
 }  // namespace mini
 
@@ -16,6 +16,18 @@ Value operator*(
     Column<Value, kSize> const& column) {
   return row.Dot(column);
 }
+// Products involving at least one expression, which is evaluated in the
+// same loop as the sum:
+template <class L, class R, class = std::enable_if_t<
+    IsOperand<L>() && IsOperand<R>() &&
+    (IsExpression<L>() || IsExpression<R>())>>
+auto operator*(L const& row, R const& column) {
+  using T = Traits<L>;
+  static_assert(T::kSize == Traits<R>::kSize);
+  typename T::Value dot{0};
+  for (int i = 0; i != T::kSize; ++i) { dot += row[i] * column[i]; }
+  return dot;
+}
 
 }  // namespace algebra
 }  // namespace mini
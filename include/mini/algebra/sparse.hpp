@@ -0,0 +1,178 @@
+//  Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_ALGEBRA_SPARSE_HPP_
+#define MINI_ALGEBRA_SPARSE_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <map>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "mini/algebra/column.hpp"
+#include "mini/algebra/lu.hpp"
+#include "mini/algebra/matrix.hpp"
+#include "mini/algebra/unroll.hpp"
+
+namespace mini {
+namespace algebra {
+
+// Block Compressed Sparse Row (BSR) matrix with kBlock-by-kBlock blocks,
+// which are stored contiguously row by row, and sorted by columns in a row.
+template <class Value, int kBlock = 1>
+class Sparse {
+ public:
+  // Types:
+  using Block = Matrix<Value, kBlock, kBlock>;
+  using Column = algebra::Column<Value, kBlock>;
+  // Constructors:
+  Sparse() = default;
+  explicit Sparse(int n_rows) : building_rows_(n_rows) {}
+  // Accessors:
+  int CountRows() const { return row_begin_.size() - 1; }
+  int CountBlocks() const { return blocks_.size(); }
+  // Index of block (row, column) in blocks, or -1 if it is not stored:
+  int Find(int row, int column) const {
+    auto first = columns_.begin() + row_begin_[row];
+    auto last = columns_.begin() + row_begin_[row + 1];
+    auto iter = std::lower_bound(first, last, column);
+    return iter != last && *iter == column ? iter - columns_.begin() : -1;
+  }
+  Block const& GetBlock(int i) const { return blocks_[i]; }
+  Block& GetBlock(int i) { return blocks_[i]; }
+  // Mutators (only before Compress()):
+  void Emplace(int row, int column, Block const& block) {
+    assert(0 <= row && row < static_cast<int>(building_rows_.size()));
+    auto result = building_rows_[row].emplace(column, block);
+    if (!result.second) {
+      auto& sum = result.first->second;
+      for (int r = 0; r != kBlock; ++r) { sum[r] += block[r]; }
+    }
+  }
+  void Compress() {
+    row_begin_.assign(1, 0);
+    columns_.clear();
+    blocks_.clear();
+    for (auto& row : building_rows_) {
+      for (auto& [column, block] : row) {
+        columns_.emplace_back(column);
+        blocks_.emplace_back(block);
+      }
+      row_begin_.emplace_back(columns_.size());
+    }
+    building_rows_.clear();
+  }
+  // Mutators (only after Compress()):
+  void SetZero() { std::fill(blocks_.begin(), blocks_.end(), Block{}); }
+  // Replace A by its block incomplete LU factorization ILU(0), which keeps
+  // the sparsity of A.  The diagonal of the unit lower triangle L is not
+  // stored, and that of the upper triangle U is kept inverted for Solve():
+  void FactorIlu() {
+    int n_rows = CountRows();
+    diagonals_.resize(n_rows);
+    inverse_diagonals_.resize(n_rows);
+    for (int i = 0; i != n_rows; ++i) {
+      diagonals_[i] = Find(i, i);
+      assert(diagonals_[i] >= 0);
+      for (int ij = row_begin_[i]; ij != diagonals_[i]; ++ij) {
+        // L(i, j) = A(i, j) * inv(U(j, j)):
+        int j = columns_[ij];
+        blocks_[ij] = blocks_[ij] * inverse_diagonals_[j];
+        // A(i, k) -= L(i, j) * U(j, k) for k > j in the pattern of both rows:
+        int ik = ij + 1, jk = diagonals_[j] + 1;
+        while (ik != row_begin_[i + 1] && jk != row_begin_[j + 1]) {
+          if (columns_[ik] < columns_[jk]) {
+            ++ik;
+          } else if (columns_[jk] < columns_[ik]) {
+            ++jk;
+          } else {
+            auto product = blocks_[ij] * blocks_[jk];
+            for (int r = 0; r != kBlock; ++r) { blocks_[ik][r] -= product[r]; }
+            ++ik;
+            ++jk;
+          }
+        }
+      }
+      inverse_diagonals_[i] = Lu<Value, kBlock>(blocks_[diagonals_[i]])
+          .Inverse();
+    }
+  }
+  // Solve L * U * x = b after FactorIlu(), in which x may alias b:
+  void Solve(Column const* b, Column* x) const {
+    int n_rows = CountRows();
+    assert(static_cast<int>(diagonals_.size()) == n_rows);
+    for (int i = 0; i != n_rows; ++i) {
+      auto sum = b[i];
+      for (int ij = row_begin_[i]; ij != diagonals_[i]; ++ij) {
+        MultiplySubtract(blocks_[ij], x[columns_[ij]], &sum);
+      }
+      x[i] = sum;
+    }
+    for (int i = n_rows - 1; i >= 0; --i) {
+      auto sum = x[i];
+      for (int ij = diagonals_[i] + 1; ij != row_begin_[i + 1]; ++ij) {
+        MultiplySubtract(blocks_[ij], x[columns_[ij]], &sum);
+      }
+      x[i] = inverse_diagonals_[i] * sum;
+    }
+  }
+  // y[first, last) = A[first, last) * x
+  void Multiply(Column const* x, Column* y, int first, int last) const {
+    for (int row = first; row != last; ++row) {
+      Column sum{};
+      for (int k = row_begin_[row]; k != row_begin_[row + 1]; ++k) {
+        auto& block = blocks_[k];
+        auto& x_k = x[columns_[k]];
+        Unroll<kBlock>([&](auto r) {
+          Unroll<kBlock>([&](auto c) { sum[r] += block[r][c] * x_k[c]; });
+        });
+      }
+      y[row] = sum;
+    }
+  }
+  // y = A * x, with rows split evenly over at most n_threads threads, each of
+  // which takes at least kMinWorkPerThread multiply-adds, so that small
+  // products are not dominated by creating and joining threads:
+  void Multiply(std::vector<Column> const& x, std::vector<Column>* y,
+                int n_threads = 1) const {
+    int n_rows = CountRows();
+    assert(static_cast<int>(x.size()) == n_rows);
+    assert(static_cast<int>(y->size()) == n_rows);
+    auto work = static_cast<std::int64_t>(CountBlocks()) * kBlock * kBlock;
+    n_threads = std::min<std::int64_t>(n_threads, work / kMinWorkPerThread);
+    if (n_threads <= 1) {
+      Multiply(x.data(), y->data(), 0, n_rows);
+      return;
+    }
+    auto threads = std::vector<std::thread>();
+    int n_rows_per_thread = (n_rows + n_threads - 1) / n_threads;
+    for (int first = 0; first < n_rows; first += n_rows_per_thread) {
+      int last = std::min(first + n_rows_per_thread, n_rows);
+      threads.emplace_back([&, first, last](){
+        Multiply(x.data(), y->data(), first, last);
+      });
+    }
+    for (auto& thread : threads) { thread.join(); }
+  }
+
+ private:
+  static constexpr std::int64_t kMinWorkPerThread = 1 << 19;
+  // y -= A * x
+  static void MultiplySubtract(Block const& a, Column const& x, Column* y) {
+    Unroll<kBlock>([&](auto r) {
+      Unroll<kBlock>([&](auto c) { (*y)[r] -= a[r][c] * x[c]; });
+    });
+  }
+  std::vector<std::map<int, Block>> building_rows_;
+  std::vector<int> row_begin_{0};
+  std::vector<int> columns_;
+  std::vector<Block> blocks_;
+  // ILU(0) only:
+  std::vector<int> diagonals_;  // index of each diagonal block
+  std::vector<Block> inverse_diagonals_;
+};
+
+}  // namespace algebra
+}  // namespace mini
+
+#endif  //  MINI_ALGEBRA_SPARSE_HPP_
@@ -0,0 +1,27 @@
+//  Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_ALGEBRA_UNROLL_HPP_
+#define MINI_ALGEBRA_UNROLL_HPP_
+
+#include <type_traits>
+#include <utility>
+
+namespace mini {
+namespace algebra {
+
+template <class Visitor, int... kIndices>
+constexpr void Unroll(Visitor&& visitor,
+                      std::integer_sequence<int, kIndices...>) {
+  (visitor(std::integral_constant<int, kIndices>()), ...);
+}
+// Call `visitor(k)` for k = 0, 1, ..., kSize - 1, in which `k` is an
+// std::integral_constant, so the loop is fully unrolled at compile time and
+// `if constexpr` may prune the body by `k`:
+template <int kSize, class Visitor>
+constexpr void Unroll(Visitor&& visitor) {
+  Unroll(visitor, std::make_integer_sequence<int, kSize>());
+}
+
+}  // namespace algebra
+}  // namespace mini
+
+#endif  //  MINI_ALGEBRA_UNROLL_HPP_
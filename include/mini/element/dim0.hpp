@@ -4,6 +4,7 @@
 #define MINI_ELEMENT_DIM0_HPP_
 
 #include <cstddef>
+#include <cstdint>
 #include <initializer_list>
 #include <utility>
 
@@ -12,11 +13,19 @@
 namespace mini {
 namespace element {
 
+// Ids of nodes, edges and faces, which are 32-bit unless MINI_USE_64BIT_ID
+// is defined at compile time:
+#ifdef MINI_USE_64BIT_ID
+using Id = std::uint64_t;
+#else
+using Id = std::uint32_t;
+#endif
+
 template <class Real, int kDim>
 class Node : public geometry::Point<Real, kDim> {
  public:
   // Types:
-  using Id = std::size_t;
+  using Id = element::Id;
   // Constructors:
   template<class... XYZ>
   Node(Id i, XYZ&&... xyz)
@@ -16,7 +16,7 @@ template <class Real, int kDim>
 class Edge : public geometry::Line<Real, kDim> {
  public:
   // Types:
-  using Id = std::size_t;
+  using Id = element::Id;
   using Node = Node<Real, kDim>;
   // Constructors:
   Edge(Id i, Node* head, Node* tail)
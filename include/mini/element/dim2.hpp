@@ -12,14 +12,18 @@
 namespace mini {
 namespace element {
 
-template <class Real, int kDim>
-class Face : virtual public geometry::Surface<Real, kDim> {
+// Common methods of a face with a concrete (non-virtual) geometric shape:
+template <class Real, int kDim, class Shape>
+class Face : public Shape {
  public:
   // Types:
-  using Id = std::size_t;
+  using Id = element::Id;
   using Node = Node<Real, kDim>;
+  // Constructors:
+  template <class... Nodes>
+  explicit Face(Id i, Nodes*... nodes) : Shape(nodes...), i_(i) {}
   // Accessors:
-  virtual Id I() const = 0;
+  Id I() const { return i_; }
   static Id DefaultId() { return -1; }
   Node* GetNode(int i) const {
     return static_cast<Node*>(this->GetPoint(i));
@@ -29,46 +33,38 @@ class Face : virtual public geometry::Surface<Real, kDim> {
   auto Integrate(Integrand&& integrand) const {
     return integrand(this->Center()) * this->Measure();
   }
+
+ private:
+  Id i_;
 };
 
 template <class Real, int kDim>
-class Triangle :
-    virtual public Face<Real, kDim>,
-    public geometry::Triangle<Real, kDim> {
+class Triangle : public Face<Real, kDim, geometry::Triangle<Real, kDim>> {
+  using Base = Face<Real, kDim, geometry::Triangle<Real, kDim>>;
+
  public:
   // Types:
-  using Id = std::size_t;
-  using Node = Node<Real, kDim>;
+  using Id = typename Base::Id;
+  using Node = typename Base::Node;
   // Constructors:
-  Triangle(Id i, Node* a, Node* b, Node* c)
-      : i_(i), geometry::Triangle<Real, kDim>(a, b, c) {}
+  Triangle(Id i, Node* a, Node* b, Node* c) : Base(i, a, b, c) {}
   Triangle(Node* a, Node* b, Node* c)
-      : Triangle(this->DefaultId(), a, b, c) {}
-  // Accessors:
-  Id I() const override { return i_; }
-  // Mesh methods:
- private:
-  Id i_;
+      : Triangle(Base::DefaultId(), a, b, c) {}
 };
 
 template <class Real, int kDim>
-class Rectangle :
-    virtual public Face<Real, kDim>,
-    public geometry::Rectangle<Real, kDim> {
+class Rectangle : public Face<Real, kDim, geometry::Rectangle<Real, kDim>> {
+  using Base = Face<Real, kDim, geometry::Rectangle<Real, kDim>>;
+
  public:
   // Types:
-  using Id = std::size_t;
-  using Node = Node<Real, kDim>;
+  using Id = typename Base::Id;
+  using Node = typename Base::Node;
   // Constructors:
   Rectangle(Id i, Node* a, Node* b, Node* c, Node* d)
-      : i_(i), geometry::Rectangle<Real, kDim>(a, b, c, d) {}
+      : Base(i, a, b, c, d) {}
   Rectangle(Node* a, Node* b, Node* c, Node* d)
-      : Rectangle(this->DefaultId(), a, b, c, d) {}
-  // Accessors:
-  Id I() const override { return i_; }
-  // Mesh methods:
- private:
-  Id i_;
+      : Rectangle(Base::DefaultId(), a, b, c, d) {}
 };
 
 }  // namespace element
@@ -10,28 +10,15 @@ namespace mini {
 namespace geometry {
 
 template <class Real, int kDim>
-class Surface {
- public:
-  // Types:
-  using Point = Point<Real, kDim>;
-  // Accessors:
-  virtual int CountVertices() const = 0;
-  virtual Point* GetPoint(int i) const = 0;
-  // Geometric methods:
-  virtual Real Measure() const = 0;
-  virtual Point Center() const = 0;
-};
-
-template <class Real, int kDim>
-class Triangle : virtual public Surface<Real, kDim> {
+class Triangle {
  public:
   // Types:
   using Point = Point<Real, kDim>;
   // Constructors:
   Triangle(Point* a, Point* b, Point* c) : a_(a), b_(b), c_(c) {}
   // Accessors:
-  int CountVertices() const override { return 3; }
-  Point* GetPoint(int i) const override {
+  static constexpr int CountVertices() { return 3; }
+  Point* GetPoint(int i) const {
     switch (i)  {
     case 0:
       return a_;
@@ -44,11 +31,11 @@ class Triangle : virtual public Surface<Real, kDim> {
     }
   }
   // Geometric methods:
-  Real Measure() const override {
+  Real Measure() const {
     auto v = (*b_ - *a_).Cross(*c_ - *a_);
     return std::abs(v) * 0.5;
   }
-  Point Center() const override {
+  Point Center() const {
     auto center = *a_;
     center += *b_;
     center += *c_;
@@ -63,7 +50,7 @@ class Triangle : virtual public Surface<Real, kDim> {
 };
 
 template <class Real, int kDim>
-class Rectangle : virtual public Surface<Real, kDim> {
+class Rectangle {
  public:
   // Types:
   using Point = Point<Real, kDim>;
@@ -71,8 +58,8 @@ class Rectangle : virtual public Surface<Real, kDim> {
   Rectangle(Point* a, Point* b, Point* c, Point* d)
       : a_(a), b_(b), c_(c) , d_(d) {}
   // Accessors:
-  int CountVertices() const override { return 4; }
-  Point* GetPoint(int i) const override {
+  static constexpr int CountVertices() { return 4; }
+  Point* GetPoint(int i) const {
     switch (i)  {
     case 0:
       return a_;
@@ -87,11 +74,11 @@ class Rectangle : virtual public Surface<Real, kDim> {
     }
   }
   // Geometric methods:
-  Real Measure() const override {
+  Real Measure() const {
     auto v = (*b_ - *a_).Cross(*c_ - *a_);
     return std::abs(v);
   }
-  Point Center() const override {
+  Point Center() const {
     auto center = *a_;
     center += *c_;
     center *= 0.5;
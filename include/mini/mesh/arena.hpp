@@ -0,0 +1,89 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#ifndef MINI_MESH_ARENA_HPP_
+#define MINI_MESH_ARENA_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mini {
+namespace mesh {
+
+// A bump allocator, which constructs objects of type T in geometrically
+// growing chunks.  Objects never move once emplaced, are laid out in creation
+// order, and are destroyed all at once when the arena dies (without touching
+// them if T is trivially destructible).
+template <class T>
+class Arena {
+  using Slot = std::aligned_storage_t<sizeof(T), alignof(T)>;
+  struct Chunk {
+    std::unique_ptr<Slot[]> slots;
+    int capacity;
+    int size;
+  };
+  static constexpr int kMinChunkSize = 1 << 6;
+  static constexpr int kMaxChunkSize = 1 << 14;
+
+ public:
+  // Constructors:
+  Arena() = default;
+  Arena(Arena const&) = delete;
+  Arena& operator=(Arena const&) = delete;
+  ~Arena() { Clear(); }
+  // Accessors:
+  std::size_t size() const { return size_; }
+  // Mutators:
+  template <class... Args>
+  T* Emplace(Args&&... args) {
+    if (chunks_.empty() || chunks_.back().size == chunks_.back().capacity) {
+      int capacity = chunks_.empty() ? kMinChunkSize :
+          std::min(chunks_.back().capacity * 2, kMaxChunkSize);
+      // No value-initialization, which would zero the whole chunk:
+      chunks_.push_back({std::unique_ptr<Slot[]>(new Slot[capacity]),
+                         capacity, 0});
+    }
+    auto& chunk = chunks_.back();
+    auto ptr = new(&chunk.slots[chunk.size]) T(std::forward<Args>(args)...);
+    ++chunk.size;
+    ++size_;
+    return ptr;
+  }
+  void Clear() {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      ForEach([](T& object) { object.~T(); });
+    }
+    chunks_.clear();
+    size_ = 0;
+  }
+  // Iterators (in creation order):
+  template <class Visitor>
+  void ForEach(Visitor&& visitor) {
+    for (auto& chunk : chunks_) {
+      for (int i = 0; i != chunk.size; ++i) {
+        visitor(*std::launder(reinterpret_cast<T*>(&chunk.slots[i])));
+      }
+    }
+  }
+  template <class Visitor>
+  void ForEach(Visitor&& visitor) const {
+    for (auto& chunk : chunks_) {
+      for (int i = 0; i != chunk.size; ++i) {
+        visitor(*std::launder(reinterpret_cast<T const*>(&chunk.slots[i])));
+      }
+    }
+  }
+
+ private:
+  std::vector<Chunk> chunks_;
+  std::size_t size_{0};
+};
+
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_ARENA_HPP_
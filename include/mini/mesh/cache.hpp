@@ -0,0 +1,279 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#ifndef MINI_MESH_CACHE_HPP_
+#define MINI_MESH_CACHE_HPP_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mini {
+namespace mesh {
+
+// A read-only view of a whole file, which is mapped into memory:
+class MappedFile {
+ public:
+  // Constructors:
+  explicit MappedFile(std::string const& file_name) {
+    auto fd = ::open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) { return; }
+    struct stat status;
+    if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+      auto data = ::mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE,
+                         fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<char const*>(data);
+        size_ = status.st_size;
+      }
+    }
+    ::close(fd);  // the mapping outlives the descriptor
+  }
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+  ~MappedFile() {
+    if (data_) { ::munmap(const_cast<char*>(data_), size_); }
+  }
+  // Accessors:
+  char const* data() const { return data_; }
+  std::size_t size() const { return size_; }
+
+ private:
+  char const* data_{nullptr};
+  std::size_t size_{0};
+};
+
+// A versioned binary image of a Mesh, together with the tags of its boundary
+// walls and the names of these tags, which is keyed by the hash of the mesh
+// file it was built from.  Reading it takes one mmap() and no parsing, but
+// its content is checked against a checksum in its header.
+template <class Mesh>
+class Cache {
+  using Node = typename Mesh::Node;
+  using Real = decltype(std::declval<Node>().X());
+  using Wall = typename Mesh::Wall;
+  using Cell = typename Mesh::Cell;
+  using NodeId = typename Node::Id;
+  using WallId = typename Wall::Id;
+  using CellId = typename Cell::Id;
+
+ public:
+  // Types:
+  using Key = std::uint64_t;
+  static constexpr std::uint32_t kVersion = 2;
+  // Hash a file by 64-bit FNV-1a, which is 0 if the file cannot be read:
+  static Key Hash(std::string const& file_name) {
+    auto file = MappedFile(file_name);
+    if (file.data() == nullptr) { return 0; }
+    Key hash = kHashBasis;
+    Hash(file.data(), file.size(), &hash);
+    return hash;
+  }
+  static std::string GetFileName(Key key) {
+    auto name = std::ostringstream();
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".mesh";
+    return name.str();
+  }
+  // Mutators:
+  // Return false if the file is absent, corrupted, stale (built from another
+  // mesh file) or of another version, in which case it should be rebuilt.
+  bool ReadFromFile(std::string const& file_name, Key key) {
+    mesh_.reset();
+    wall_to_tag_.clear();
+    tag_to_name_.clear();
+    auto file = MappedFile(file_name);
+    auto data = file.data();
+    if (data == nullptr || file.size() < sizeof(Header)) { return false; }
+    auto& header = *reinterpret_cast<Header const*>(data);
+    if (!header.Match(key)) { return false; }
+    // Counts are bounded first, so that the sizes below cannot overflow:
+    for (auto count : {header.n_nodes, header.n_walls, header.n_cells,
+                       header.names_size}) {
+      if (count > file.size()) { return false; }
+    }
+    auto size = sizeof(Header) + header.n_nodes * sizeof(NodeRecord)
+        + header.n_walls * sizeof(WallRecord)
+        + header.n_cells * sizeof(CellRecord) + header.names_size;
+    if (file.size() != size) { return false; }
+    // Records are trusted only if they are what WriteToFile() wrote:
+    auto checksum = kHashBasis;
+    Hash(data + sizeof(Header), size - sizeof(Header), &checksum);
+    if (checksum != header.checksum) { return false; }
+    auto nodes = reinterpret_cast<NodeRecord const*>(&header + 1);
+    auto walls = reinterpret_cast<WallRecord const*>(nodes + header.n_nodes);
+    auto cells = reinterpret_cast<CellRecord const*>(walls + header.n_walls);
+    auto names = reinterpret_cast<char const*>(cells + header.n_cells);
+    mesh_ = std::make_unique<Mesh>();
+    for (std::uint64_t i = 0; i != header.n_nodes; ++i) {
+      mesh_->EmplaceNode(nodes[i].id, nodes[i].x, nodes[i].y);
+    }
+    // Walls are emplaced before cells, so their ids and order are kept:
+    for (std::uint64_t i = 0; i != header.n_walls; ++i) {
+      auto& record = walls[i];
+      auto wall = mesh_->EmplaceWall(record.id, record.head, record.tail);
+      if (record.tag) { wall_to_tag_.emplace(wall, record.tag); }
+    }
+    // Nodes of each cell are in counterclockwise order, so no one is swapped:
+    for (std::uint64_t i = 0; i != header.n_cells; ++i) {
+      auto& record = cells[i];
+      auto& n = record.nodes;
+      if (record.n_nodes == 3) {
+        mesh_->EmplaceCell(record.id, {n[0], n[1], n[2]});
+      } else {
+        mesh_->EmplaceCell(record.id, {n[0], n[1], n[2], n[3]});
+      }
+    }
+    // Each name is stored as (tag, length, characters):
+    for (auto p = names; p != names + header.names_size;) {
+      std::int32_t tag;
+      std::uint32_t length;
+      std::memcpy(&tag, p, sizeof(tag));
+      std::memcpy(&length, p + sizeof(tag), sizeof(length));
+      p += sizeof(tag) + sizeof(length);
+      tag_to_name_.emplace(tag, std::string(p, length));
+      p += length;
+    }
+    return true;
+  }
+  // Write to a temporary file, which is then renamed, so that concurrent
+  // runs never see a partially written cache.
+  static bool WriteToFile(
+      std::string const& file_name, Key key, Mesh const& mesh,
+      std::unordered_map<Wall const*, int> const& wall_to_tag,
+      std::map<int, std::string> const& tag_to_name) {
+    auto temp_name = file_name + "." + std::to_string(::getpid());
+    auto file = std::ofstream(temp_name, std::ios::binary);
+    if (!file) { return false; }
+    auto header = Header();
+    header.key = key;
+    header.checksum = kHashBasis;
+    header.n_nodes = mesh.CountNodes();
+    header.n_walls = mesh.CountWalls();
+    header.n_cells = mesh.CountCells();
+    for (auto& pair : tag_to_name) {
+      header.names_size += sizeof(std::int32_t) + sizeof(std::uint32_t)
+          + pair.second.size();
+    }
+    Write(file, header);  // rewritten with the checksum of records
+    auto write = [&](auto const& value) {
+      Write(file, value);
+      Hash(reinterpret_cast<char const*>(&value), sizeof(value),
+           &header.checksum);
+    };
+    mesh.ForEachNode([&](Node const& node) {
+      write(NodeRecord{node.I(), node.X(), node.Y()});
+    });
+    mesh.ForEachWall([&](Wall const& wall) {
+      auto iter = wall_to_tag.find(&wall);
+      auto tag = iter == wall_to_tag.end() ? 0 : iter->second;
+      write(WallRecord{wall.I(), wall.Head()->I(), wall.Tail()->I(), tag});
+    });
+    mesh.ForEachCell([&](Cell const& cell) {
+      auto record = CellRecord{cell.I(), {}, cell.CountVertices()};
+      for (int i = 0; i != record.n_nodes; ++i) {
+        record.nodes[i] = cell.GetNode(i)->I();
+      }
+      write(record);
+    });
+    for (auto& pair : tag_to_name) {
+      write(static_cast<std::int32_t>(pair.first));
+      write(static_cast<std::uint32_t>(pair.second.size()));
+      file.write(pair.second.data(), pair.second.size());
+      Hash(pair.second.data(), pair.second.size(), &header.checksum);
+    }
+    file.seekp(0);
+    Write(file, header);
+    file.close();
+    if (!file || std::rename(temp_name.c_str(), file_name.c_str())) {
+      std::remove(temp_name.c_str());
+      return false;
+    }
+    return true;
+  }
+  // Accessors:
+  std::unique_ptr<Mesh> GetMesh() {
+    auto temp = std::make_unique<Mesh>();
+    std::swap(temp, mesh_);
+    return temp;
+  }
+  std::unordered_map<Wall const*, int> const& GetWallTags() const {
+    return wall_to_tag_;
+  }
+  std::map<int, std::string> const& GetBoundaryNames() const {
+    return tag_to_name_;
+  }
+
+ private:
+  static constexpr Key kHashBasis = 0xcbf29ce484222325;
+  // Continue hashing by `size` more bytes:
+  static void Hash(char const* data, std::size_t size, Key* hash) {
+    for (std::size_t i = 0; i != size; ++i) {
+      *hash ^= static_cast<unsigned char>(data[i]);
+      *hash *= 0x100000001b3;
+    }
+  }
+  struct Header {
+    char magic[8] = "miniCFD";
+    std::uint32_t version{kVersion};
+    std::uint16_t real_size{sizeof(Real)}, id_size{sizeof(NodeId)};
+    Key key{0};
+    std::uint64_t n_nodes{0}, n_walls{0}, n_cells{0}, names_size{0};
+    Key checksum{0};  // of all bytes after the header
+    bool Match(Key that) const {
+      auto expected = Header();
+      return std::memcmp(magic, expected.magic, sizeof(magic)) == 0 &&
+          version == kVersion && real_size == sizeof(Real) &&
+          id_size == sizeof(NodeId) && key == that;
+    }
+  };
+  struct NodeRecord {
+    NodeId id;
+    Real x, y;
+  };
+  struct WallRecord {
+    WallId id;
+    NodeId head, tail;
+    std::int32_t tag;  // 0 if not tagged
+  };
+  struct CellRecord {
+    CellId id;
+    NodeId nodes[4];
+    std::int32_t n_nodes;
+  };
+  static_assert(std::is_trivially_copyable_v<Header>);
+  static_assert(std::is_trivially_copyable_v<NodeRecord>);
+  static_assert(std::is_trivially_copyable_v<WallRecord>);
+  static_assert(std::is_trivially_copyable_v<CellRecord>);
+  // Records follow each other without padding in between:
+  static_assert(sizeof(Header) % alignof(NodeRecord) == 0);
+  static_assert(sizeof(NodeRecord) % alignof(WallRecord) == 0);
+  static_assert(sizeof(WallRecord) % alignof(CellRecord) == 0);
+  template <class T>
+  static void Write(std::ostream& out, T const& value) {
+    out.write(reinterpret_cast<char const*>(&value), sizeof(T));
+  }
+
+ private:
+  std::unique_ptr<Mesh> mesh_;
+  std::unordered_map<Wall const*, int> wall_to_tag_;
+  std::map<int, std::string> tag_to_name_;
+};
+
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_CACHE_HPP_
@@ -8,17 +8,18 @@
 #include <cassert>
 #include <cmath>
 #include <cstddef>
-#include <forward_list>
 #include <initializer_list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "mini/element/dim1.hpp"
 #include "mini/element/dim2.hpp"
+#include "mini/mesh/arena.hpp"
 #include "mini/mesh/data.hpp"
 
 namespace mini {
@@ -112,29 +113,87 @@ template <class Real, class NodeData, class WallData, class CellData>
 std::array<std::string, WallData::CountVectors()>
 Wall<Real, NodeData, WallData, CellData>::vector_names;
 
+// The common part of all cells, whose geometric methods are dispatched to
+// the concrete type by a tag rather than by virtual functions:
 template <class Real, class NodeData, class WallData, class CellData>
-class Cell : virtual public element::Face<Real, 2> {
+class Cell {
   friend class Mesh<Real, NodeData, WallData, CellData>;
+  using Triangle = Triangle<Real, NodeData, WallData, CellData>;
+  using Rectangle = Rectangle<Real, NodeData, WallData, CellData>;
+
  public:
-  virtual ~Cell() = default;
   // Types:
-  using Id = typename element::Face<Real, 2>::Id;
+  using Id = element::Id;
   using Data = CellData;
   using Wall = Wall<Real, NodeData, WallData, CellData>;
   using Node = typename Wall::Node;
+  using Point = geometry::Point<Real, 2>;
+  enum class Kind { kTriangle, kRectangle };
   // Public data members:
   Data data;
   static std::array<std::string, CellData::CountScalars()> scalar_names;
   static std::array<std::string, CellData::CountVectors()> vector_names;
   // Constructors:
-  Cell(std::initializer_list<Wall*> walls) : walls_{walls} {}
+  Cell(Kind kind, std::initializer_list<Wall*> walls)
+      : kind_(kind), n_walls_(walls.size()) {
+    assert(walls.size() <= walls_.size());
+    std::copy(walls.begin(), walls.end(), walls_.begin());
+  }
+  // Accessors:
+  Kind GetKind() const { return kind_; }
+  Id I() const {
+    return Visit([](auto const& cell) { return cell.I(); });
+  }
+  int CountVertices() const {
+    return Visit([](auto const& cell) { return cell.CountVertices(); });
+  }
+  Point* GetPoint(int i) const {
+    return Visit([i](auto const& cell) { return cell.GetPoint(i); });
+  }
+  auto GetNode(int i) const {
+    return Visit([i](auto const& cell) { return cell.GetNode(i); });
+  }
+  // Geometric methods:
+  Real Measure() const {
+    return Visit([](auto const& cell) { return cell.Measure(); });
+  }
+  Point Center() const {
+    return Visit([](auto const& cell) { return cell.Center(); });
+  }
+  template <class Integrand>
+  auto Integrate(Integrand&& integrand) const {
+    return integrand(Center()) * Measure();
+  }
+  // Mutators:
+  void ReplaceWall(Wall const* old_wall, Wall* new_wall) {
+    for (int i = 0; i != n_walls_; ++i) {
+      if (walls_[i] == old_wall) { walls_[i] = new_wall; }
+    }
+  }
   // Iterators:
   template <class Visitor>
   void ForEachWall(Visitor&& visitor) {
-    for (auto& b : walls_) { visitor(*b); }
+    for (int i = 0; i != n_walls_; ++i) { visitor(*walls_[i]); }
+  }
+  template <class Visitor>
+  void ForEachWall(Visitor&& visitor) const {
+    for (int i = 0; i != n_walls_; ++i) { visitor(*walls_[i]); }
   }
+  // Call visitor(cell) with the concrete type of this cell:
+  template <class Visitor>
+  decltype(auto) Visit(Visitor&& visitor) const {
+    if (kind_ == Kind::kTriangle) {
+      return visitor(static_cast<Triangle const&>(*this));
+    } else {
+      assert(kind_ == Kind::kRectangle);
+      return visitor(static_cast<Rectangle const&>(*this));
+    }
+  }
+
  protected:
-  std::forward_list<Wall*> walls_;
+  Kind kind_;
+  int n_walls_;
+  std::array<Wall*, 4> walls_;
 };
 template <class Real, class NodeData, class WallData, class CellData>
 std::array<std::string, CellData::CountScalars()>
@@ -148,6 +207,8 @@ template <class Real, class NodeData, class WallData, class CellData>
 class Triangle
     : public Cell<Real, NodeData, WallData, CellData>,
       public element::Triangle<Real, 2> {
+  using Element = element::Triangle<Real, 2>;
+
  public:
   using Cell = Cell<Real, NodeData, WallData, CellData>;
   // Types:
@@ -158,13 +219,23 @@ class Triangle
   // Constructors:
   Triangle(Id i, Node* a, Node* b, Node* c,
            std::initializer_list<Wall*> walls)
-      : element::Triangle<Real, 2>(i, a, b, c), Cell{walls} {}
+      : Cell{Cell::Kind::kTriangle, walls}, Element(i, a, b, c) {}
+  // Statically bound methods, which hide the dispatching ones in Cell:
+  using Element::I;
+  using Element::CountVertices;
+  using Element::GetPoint;
+  using Element::GetNode;
+  using Element::Measure;
+  using Element::Center;
+  using Element::Integrate;
 };
 
 template <class Real, class NodeData, class WallData, class CellData>
 class Rectangle
     : public Cell<Real, NodeData, WallData, CellData>,
       public element::Rectangle<Real, 2> {
+  using Element = element::Rectangle<Real, 2>;
+
  public:
   using Cell = Cell<Real, NodeData, WallData, CellData>;
   // Types:
@@ -175,7 +246,15 @@ class Rectangle
   // Constructors:
   Rectangle(Id i, Node* a, Node* b, Node* c, Node* d,
             std::initializer_list<Wall*> walls)
-      : element::Rectangle<Real, 2>(i, a, b, c, d), Cell{walls} {}
+      : Cell{Cell::Kind::kRectangle, walls}, Element(i, a, b, c, d) {}
+  // Statically bound methods, which hide the dispatching ones in Cell:
+  using Element::I;
+  using Element::CountVertices;
+  using Element::GetPoint;
+  using Element::GetNode;
+  using Element::Measure;
+  using Element::Center;
+  using Element::Integrate;
 };
 
 template <class Real, class NodeData, class WallData, class CellData>
@@ -198,28 +277,63 @@ class Mesh {
   // Constructors:
   Mesh() = default;
   // Count primitive objects.
-  auto CountNodes() const { return id_to_node_.size(); }
-  auto CountWalls() const { return id_to_wall_.size(); }
-  auto CountCells() const { return id_to_cell_.size(); }
-  // Traverse primitive objects.
+  auto CountNodes() const { return nodes_.size(); }
+  auto CountWalls() const { return walls_.size(); }
+  auto CountCells() const { return triangles_.size() + rectangles_.size(); }
+  auto CountTriangles() const { return triangles_.size(); }
+  auto CountRectangles() const { return rectangles_.size(); }
+  // Traverse primitive objects (in creation order).
+  template <class Visitor>
+  void ForEachNode(Visitor&& visitor) {
+    nodes_.ForEach(visitor);
+  }
   template <class Visitor>
   void ForEachNode(Visitor&& visitor) const {
-    for (auto& [id, node_ptr] : id_to_node_) { visitor(*node_ptr); }
+    nodes_.ForEach(visitor);
+  }
+  template <class Visitor>
+  void ForEachWall(Visitor&& visitor) {
+    walls_.ForEach(visitor);
   }
   template <class Visitor>
   void ForEachWall(Visitor&& visitor) const {
-    for (auto& [id, wall_ptr] : id_to_wall_) { visitor(*wall_ptr); }
+    walls_.ForEach(visitor);
+  }
+  // Visit cells block by block, so that a generic visitor is instantiated
+  // (and inlined) once for each concrete cell type:
+  template <class Visitor>
+  void ForEachCell(Visitor&& visitor) {
+    ForEachTriangle(visitor);
+    ForEachRectangle(visitor);
   }
   template <class Visitor>
   void ForEachCell(Visitor&& visitor) const {
-    for (auto& [id, cell_ptr] : id_to_cell_) { visitor(*cell_ptr); }
+    ForEachTriangle(visitor);
+    ForEachRectangle(visitor);
+  }
+  template <class Visitor>
+  void ForEachTriangle(Visitor&& visitor) {
+    triangles_.ForEach(visitor);
+  }
+  template <class Visitor>
+  void ForEachTriangle(Visitor&& visitor) const {
+    triangles_.ForEach(visitor);
+  }
+  template <class Visitor>
+  void ForEachRectangle(Visitor&& visitor) {
+    rectangles_.ForEach(visitor);
+  }
+  template <class Visitor>
+  void ForEachRectangle(Visitor&& visitor) const {
+    rectangles_.ForEach(visitor);
   }
 
   // Emplace primitive objects.
   Node* EmplaceNode(NodeId i, Real x, Real y) {
-    auto node_unique_ptr = std::make_unique<Node>(i, x, y);
-    auto node_ptr = node_unique_ptr.get();
-    id_to_node_.emplace(i, std::move(node_unique_ptr));
+    // Re-emplace a node is not allowed:
+    assert(id_to_node_.count(i) == 0);
+    auto node_ptr = nodes_.Emplace(i, x, y);
+    id_to_node_.emplace(i, node_ptr);
     return node_ptr;
   }
   Wall* EmplaceWall(WallId wall_id, NodeId head_id, NodeId tail_id) {
@@ -232,13 +346,11 @@ class Mesh {
     // Re-emplace an wall is not allowed:
     assert(node_pair_to_wall_.count(node_pair) == 0);
     // Emplace a new wall:
-    auto wall_unique_ptr = std::make_unique<Wall>(wall_id,
-                                                  head_iter->second.get(),
-                                                  tail_iter->second.get());
-    auto wall_ptr = wall_unique_ptr.get();
+    auto wall_ptr = walls_.Emplace(wall_id, head_iter->second,
+                                   tail_iter->second);
     node_pair_to_wall_.emplace(node_pair, wall_ptr);
-    id_to_wall_.emplace(wall_id, std::move(wall_unique_ptr));
-    assert(id_to_wall_.size() == node_pair_to_wall_.size());
+    next_wall_id_ = std::max<WallId>(next_wall_id_, wall_id + 1);
+    assert(walls_.size() == node_pair_to_wall_.size());
     return wall_ptr;
   }
   Wall* EmplaceWall(NodeId head_id, NodeId tail_id) {
@@ -247,20 +359,16 @@ class Mesh {
     auto iter = node_pair_to_wall_.find(node_pair);
     if (iter != node_pair_to_wall_.end()) {
       return iter->second;
-    } else {  // Emplace a new wall:
-      auto last = id_to_wall_.rbegin();
-      WallId wall_id = 0;
-      if (last != id_to_wall_.rend()) {  // Find the next unused id:
-        wall_id = last->first + 1;
-        while (id_to_wall_.count(wall_id)) { ++wall_id; }
-      }
-      auto wall_ptr = EmplaceWall(wall_id, head_id, tail_id);
-      node_pair_to_wall_.emplace(node_pair, wall_ptr);
-      return wall_ptr;
+    } else {  // Emplace a new wall with the next unused id:
+      return EmplaceWall(next_wall_id_, head_id, tail_id);
     }
   }
+  // Find the wall between two nodes, which is nullptr if not found:
+  Wall* GetWall(NodeId head_id, NodeId tail_id) const {
+    auto iter = node_pair_to_wall_.find(std::minmax(head_id, tail_id));
+    return iter == node_pair_to_wall_.end() ? nullptr : iter->second;
+  }
   Cell* EmplaceCell(CellId i, std::initializer_list<NodeId> nodes) {
-    std::unique_ptr<Cell> cell_unique_ptr{nullptr};
     if (nodes.size() == 3) {
       return EmplaceTriangle(i, nodes);
     } else if (nodes.size() == 4) {
@@ -282,7 +390,7 @@ class Mesh {
       wall->SetNegativeSide(cell);
     }
   }
-  Node* GetNode(NodeId i) const { return id_to_node_.at(i).get(); }
+  Node* GetNode(NodeId i) const { return id_to_node_.at(i); }
   Cell* EmplaceTriangle(CellId i, std::initializer_list<NodeId> nodes) {
     auto* p = nodes.begin();
     auto a = GetNode(p[0]);
@@ -294,9 +402,7 @@ class Mesh {
     auto edges = {EmplaceWall(a, b),
                   EmplaceWall(b, c),
                   EmplaceWall(c, a)};
-    auto cell_unique_ptr = std::make_unique<Triangle>(i, a, b, c, edges);
-    auto cell_ptr = cell_unique_ptr.get();
-    id_to_cell_.emplace(i, std::move(cell_unique_ptr));
+    auto cell_ptr = triangles_.Emplace(i, a, b, c, edges);
     LinkCellToWall(cell_ptr, a, b);
     LinkCellToWall(cell_ptr, b, c);
     LinkCellToWall(cell_ptr, c, a);
@@ -316,9 +422,7 @@ class Mesh {
                   EmplaceWall(b, c),
                   EmplaceWall(c, d),
                   EmplaceWall(d, a)};
-    auto cell_unique_ptr = std::make_unique<Rectangle>(i, a, b, c, d, edges);
-    auto cell_ptr = cell_unique_ptr.get();
-    id_to_cell_.emplace(i, std::move(cell_unique_ptr));
+    auto cell_ptr = rectangles_.Emplace(i, a, b, c, d, edges);
     LinkCellToWall(cell_ptr, a, b);
     LinkCellToWall(cell_ptr, b, c);
     LinkCellToWall(cell_ptr, c, d);
@@ -327,9 +431,14 @@ class Mesh {
   }
 
  private:
-  std::map<NodeId, std::unique_ptr<Node>> id_to_node_;
-  std::map<WallId, std::unique_ptr<Wall>> id_to_wall_;
-  std::map<CellId, std::unique_ptr<Cell>> id_to_cell_;
+  // Entities live in arenas, in creation order:
+  Arena<Node> nodes_;
+  Arena<Wall> walls_;
+  Arena<Triangle> triangles_;
+  Arena<Rectangle> rectangles_;
+  // Indices for lookup:
+  std::unordered_map<NodeId, Node*> id_to_node_;
+  WallId next_wall_id_{0};
   std::map<std::pair<NodeId, NodeId>, Wall*> node_pair_to_wall_;
 };
 
@@ -0,0 +1,308 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#ifndef MINI_MESH_GMSH_HPP_
+#define MINI_MESH_GMSH_HPP_
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mini {
+namespace mesh {
+
+// A reader of Gmsh's .msh files (versions 2.2 and 4.1, ASCII or binary).
+// Besides the Mesh, it keeps the physical group of each cell and of each wall
+// given by a line element, so that boundaries can be named by the groups.
+template <class Mesh>
+class GmshReader {
+  using NodeId = typename Mesh::Node::Id;
+  using CellId = typename Mesh::Cell::Id;
+  using Wall = typename Mesh::Wall;
+  using Cell = typename Mesh::Cell;
+
+ public:
+  // Types:
+  using Key = std::pair<int, int>;  // (dim, physical tag)
+  // Mutators:
+  bool ReadFromFile(std::string const& file_name) {
+    auto file = std::ifstream(file_name, std::ios::binary);
+    if (!file) {
+      throw std::runtime_error("Cannot open `" + file_name + "`.");
+    }
+    mesh_ = std::make_unique<Mesh>();
+    names_.clear();
+    entity_to_physical_.clear();
+    lines_.clear();
+    wall_to_tag_.clear();
+    cell_to_tag_.clear();
+    next_cell_id_ = 0;
+    auto section = std::string();
+    while (file >> section) {
+      if (section == "$MeshFormat") {
+        ReadFormat(file);
+      } else if (section == "$PhysicalNames") {
+        ReadPhysicalNames(file);
+      } else if (section == "$Entities") {
+        ReadEntities(file);
+      } else if (section == "$Nodes") {
+        version_ < 4 ? ReadNodesV2(file) : ReadNodesV4(file);
+      } else if (section == "$Elements") {
+        version_ < 4 ? ReadElementsV2(file) : ReadElementsV4(file);
+      } else {  // e.g. $Periodic or $NodeData, which are not used
+        SkipSection(file, section);
+        continue;
+      }
+      ExpectEnd(file, section);
+    }
+    LinkLinesToWalls();
+    return true;
+  }
+  // Accessors:
+  std::unique_ptr<Mesh> GetMesh() {
+    auto temp = std::make_unique<Mesh>();
+    std::swap(temp, mesh_);
+    return temp;
+  }
+  std::map<Key, std::string> const& GetPhysicalNames() const {
+    return names_;
+  }
+  // Physical tags of walls and cells, which are absent if not in any group:
+  std::unordered_map<Wall const*, int> const& GetWallTags() const {
+    return wall_to_tag_;
+  }
+  std::unordered_map<Cell const*, int> const& GetCellTags() const {
+    return cell_to_tag_;
+  }
+
+ private:
+  struct Line {
+    NodeId head, tail;
+    int tag;
+  };
+  // Read a value, which is an ASCII token or raw bytes:
+  template <class T>
+  T Get(std::istream& in) const {
+    T value;
+    if (binary_) {
+      in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    } else {
+      in >> value;
+    }
+    if (!in) { throw std::runtime_error("Corrupted .msh file."); }
+    return value;
+  }
+  // Read a `size_t` of version 4, whose width is given by the header:
+  std::size_t GetSize(std::istream& in) const {
+    if (binary_ && data_size_ == 4) { return Get<std::uint32_t>(in); }
+    return Get<std::uint64_t>(in);
+  }
+  // Skip the rest of the current line, after which binary data begin:
+  void BeginBinary(std::istream& in) const {
+    if (binary_) {
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+  }
+  static void ExpectEnd(std::istream& in, std::string const& section) {
+    auto end = std::string();
+    in >> end;
+    if (end != "$End" + section.substr(1)) {
+      throw std::runtime_error("`" + section + "` is not closed.");
+    }
+  }
+  static void SkipSection(std::istream& in, std::string const& section) {
+    auto end = "$End" + section.substr(1);
+    auto word = std::string();
+    while (in >> word && word != end) {}
+  }
+  static int CountNodes(int type) {
+    switch (type) {
+    case 15: return 1;  // point
+    case 1: return 2;  // line
+    case 2: return 3;  // triangle
+    case 3: return 4;  // quadrangle
+    default:
+      throw std::invalid_argument("Unsupported element type " +
+                                  std::to_string(type) + ".");
+    }
+  }
+  void ReadFormat(std::istream& in) {
+    int file_type;
+    in >> version_ >> file_type >> data_size_;
+    auto is_v2 = (2 <= version_ && version_ < 3);
+    auto is_v4 = (4.1 <= version_ && version_ < 5);
+    if (!is_v2 && !is_v4) {
+      throw std::invalid_argument("Only MSH 2.2 and 4.1 are supported.");
+    }
+    binary_ = (file_type == 1);
+    BeginBinary(in);
+    if (binary_ && Get<int>(in) != 1) {
+      throw std::invalid_argument("Unsupported byte order.");
+    }
+  }
+  void ReadPhysicalNames(std::istream& in) {
+    int n;
+    in >> n;
+    for (int i = 0; i != n; ++i) {
+      int dim, tag;
+      auto name = std::string();
+      in >> dim >> tag >> std::quoted(name);
+      names_.emplace(Key{dim, tag}, name);
+    }
+  }
+  void ReadEntities(std::istream& in) {
+    BeginBinary(in);
+    std::size_t counts[4];
+    for (auto& count : counts) { count = GetSize(in); }
+    for (int dim = 0; dim != 4; ++dim) {
+      for (std::size_t i = 0; i != counts[dim]; ++i) {
+        auto tag = Get<int>(in);
+        for (int k = (dim ? 6 : 3); k; --k) { Get<double>(in); }
+        auto n_physicals = GetSize(in);
+        auto physical = 0;
+        for (std::size_t k = 0; k != n_physicals; ++k) {
+          auto that = Get<int>(in);
+          if (k == 0) { physical = that; }  // the first group wins
+        }
+        entity_to_physical_.emplace(Key{dim, tag}, physical);
+        if (dim) {
+          auto n_bounds = GetSize(in);
+          for (std::size_t k = 0; k != n_bounds; ++k) { Get<int>(in); }
+        }
+      }
+    }
+  }
+  void ReadNodesV2(std::istream& in) {
+    std::size_t n;
+    in >> n;
+    BeginBinary(in);
+    for (std::size_t i = 0; i != n; ++i) {
+      auto id = Get<int>(in);
+      auto x = Get<double>(in), y = Get<double>(in);
+      Get<double>(in);
+      mesh_->EmplaceNode(id, x, y);
+    }
+  }
+  void ReadNodesV4(std::istream& in) {
+    BeginBinary(in);
+    auto n_blocks = GetSize(in);
+    GetSize(in), GetSize(in), GetSize(in);  // n_nodes, min_tag, max_tag
+    auto ids = std::vector<NodeId>();
+    for (std::size_t b = 0; b != n_blocks; ++b) {
+      auto dim = Get<int>(in);
+      Get<int>(in);  // entity tag
+      auto parametric = Get<int>(in);
+      auto n = GetSize(in);
+      ids.resize(n);
+      for (auto& id : ids) { id = GetSize(in); }
+      for (auto id : ids) {
+        auto x = Get<double>(in), y = Get<double>(in);
+        Get<double>(in);
+        for (int k = parametric ? dim : 0; k; --k) { Get<double>(in); }
+        mesh_->EmplaceNode(id, x, y);
+      }
+    }
+  }
+  void ReadElementsV2(std::istream& in) {
+    std::size_t n;
+    in >> n;
+    BeginBinary(in);
+    auto nodes = std::vector<NodeId>();
+    auto read_element = [&](int type, int n_tags) {
+      auto physical = 0;
+      for (int k = 0; k != n_tags; ++k) {
+        auto tag = Get<int>(in);
+        if (k == 0) { physical = tag; }
+      }
+      nodes.resize(CountNodes(type));
+      for (auto& node : nodes) { node = Get<int>(in); }
+      AddElement(type, physical, nodes);
+    };
+    if (binary_) {
+      // Elements are grouped by blocks sharing (type, n_tags):
+      for (std::size_t i = 0; i != n;) {
+        auto type = Get<int>(in);
+        auto n_elements = Get<int>(in);
+        auto n_tags = Get<int>(in);
+        for (int k = 0; k != n_elements; ++k, ++i) {
+          Get<int>(in);  // element id
+          read_element(type, n_tags);
+        }
+      }
+    } else {
+      for (std::size_t i = 0; i != n; ++i) {
+        Get<int>(in);  // element id
+        auto type = Get<int>(in);
+        auto n_tags = Get<int>(in);
+        read_element(type, n_tags);
+      }
+    }
+  }
+  void ReadElementsV4(std::istream& in) {
+    BeginBinary(in);
+    auto n_blocks = GetSize(in);
+    GetSize(in), GetSize(in), GetSize(in);  // n_elements, min_tag, max_tag
+    auto nodes = std::vector<NodeId>();
+    for (std::size_t b = 0; b != n_blocks; ++b) {
+      auto dim = Get<int>(in);
+      auto entity = Get<int>(in);
+      auto type = Get<int>(in);
+      auto n = GetSize(in);
+      auto iter = entity_to_physical_.find(Key{dim, entity});
+      auto physical = iter == entity_to_physical_.end() ? 0 : iter->second;
+      nodes.resize(CountNodes(type));
+      for (std::size_t i = 0; i != n; ++i) {
+        GetSize(in);  // element tag
+        for (auto& node : nodes) { node = GetSize(in); }
+        AddElement(type, physical, nodes);
+      }
+    }
+  }
+  void AddElement(int type, int physical, std::vector<NodeId> const& nodes) {
+    Cell* cell = nullptr;
+    if (type == 1) {
+      if (physical) { lines_.push_back({nodes[0], nodes[1], physical}); }
+    } else if (type == 2) {
+      cell = mesh_->EmplaceCell(next_cell_id_++, {nodes[0], nodes[1],
+                                                  nodes[2]});
+    } else if (type == 3) {
+      cell = mesh_->EmplaceCell(next_cell_id_++, {nodes[0], nodes[1],
+                                                  nodes[2], nodes[3]});
+    }
+    if (cell && physical) { cell_to_tag_.emplace(cell, physical); }
+  }
+  void LinkLinesToWalls() {
+    for (auto& line : lines_) {
+      auto wall = mesh_->GetWall(line.head, line.tail);
+      if (wall == nullptr) {
+        throw std::invalid_argument("A line element is not a `Wall`.");
+      }
+      wall_to_tag_.emplace(wall, line.tag);
+    }
+    lines_.clear();
+  }
+
+ private:
+  std::unique_ptr<Mesh> mesh_;
+  double version_{0.0};
+  int data_size_{8};
+  bool binary_{false};
+  CellId next_cell_id_{0};
+  std::map<Key, std::string> names_;
+  std::map<Key, int> entity_to_physical_;
+  std::vector<Line> lines_;
+  std::unordered_map<Wall const*, int> wall_to_tag_;
+  std::unordered_map<Cell const*, int> cell_to_tag_;
+};
+
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_GMSH_HPP_
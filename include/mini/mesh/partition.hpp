@@ -0,0 +1,428 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#ifndef MINI_MESH_PARTITION_HPP_
+#define MINI_MESH_PARTITION_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mini {
+namespace mesh {
+
+// An undirected graph with weighted vertices and edges, stored in CSR form.
+class Graph {
+ public:
+  // Types:
+  using Weight = int;
+  struct Edge {
+    int head, tail;
+    Weight weight;
+  };
+  // Constructors:
+  Graph() = default;
+  Graph(int n_vertices, std::vector<Edge> const& edges)
+      : Graph(std::vector<Weight>(n_vertices, 1), edges) {}
+  Graph(std::vector<Weight> vertex_weights, std::vector<Edge> const& edges)
+      : vertex_weights_(std::move(vertex_weights)) {
+    int n = CountVertices();
+    begin_.assign(n + 1, 0);
+    for (auto& edge : edges) {
+      assert(edge.head != edge.tail);
+      ++begin_[edge.head + 1];
+      ++begin_[edge.tail + 1];
+    }
+    std::partial_sum(begin_.begin(), begin_.end(), begin_.begin());
+    neighbors_.resize(begin_[n]);
+    edge_weights_.resize(begin_[n]);
+    auto next = std::vector<int>(begin_.begin(), begin_.end() - 1);
+    for (auto& edge : edges) {
+      neighbors_[next[edge.head]] = edge.tail;
+      edge_weights_[next[edge.head]++] = edge.weight;
+      neighbors_[next[edge.tail]] = edge.head;
+      edge_weights_[next[edge.tail]++] = edge.weight;
+    }
+  }
+  // Accessors:
+  int CountVertices() const { return vertex_weights_.size(); }
+  Weight GetVertexWeight(int v) const { return vertex_weights_[v]; }
+  Weight GetTotalWeight() const {
+    return std::accumulate(vertex_weights_.begin(), vertex_weights_.end(), 0);
+  }
+  template <class Visitor>
+  void ForEachNeighbor(int v, Visitor&& visitor) const {
+    for (int k = begin_[v]; k != begin_[v + 1]; ++k) {
+      visitor(neighbors_[k], edge_weights_[k]);
+    }
+  }
+  // Total weight of edges whose ends are in different parts:
+  Weight GetCut(std::vector<int> const& parts) const {
+    Weight cut = 0;
+    for (int v = 0; v != CountVertices(); ++v) {
+      ForEachNeighbor(v, [&](int u, Weight w) {
+        if (v < u && parts[v] != parts[u]) { cut += w; }
+      });
+    }
+    return cut;
+  }
+  // Split into n_parts parts of (almost) equal weight with a small cut, by
+  // recursive multilevel bisection: each bisection coarsens the graph by
+  // heavy-edge matching, bisects the coarsest graph by greedy growing, then
+  // projects it back level by level with Fiduccia-Mattheyses refinement.
+  std::vector<int> Partition(int n_parts, double imbalance = 0.03) const {
+    assert(n_parts >= 1);
+    auto parts = std::vector<int>(CountVertices());
+    auto vertices = std::vector<int>(CountVertices());
+    std::iota(vertices.begin(), vertices.end(), 0);
+    auto random = std::mt19937();
+    // Share the tolerance among the levels of recursive bisection:
+    int n_levels = std::ceil(std::log2(n_parts));
+    imbalance = std::pow(1 + imbalance, 1.0 / std::max(n_levels, 1)) - 1;
+    Partition(vertices, 0, n_parts, imbalance, &random, &parts);
+    return parts;
+  }
+
+ private:
+  static constexpr int kCoarsestSize = 64;
+  static constexpr int kInitialTrials = 8;
+  static constexpr int kRefinementPasses = 8;
+  static constexpr int kMaxFruitlessMoves = 64;
+
+  // Partition the subgraph induced by vertices into parts [first, first + n):
+  void Partition(std::vector<int> const& vertices, int first, int n,
+                 double imbalance, std::mt19937* random,
+                 std::vector<int>* parts) const {
+    if (n == 1) {
+      for (auto v : vertices) { (*parts)[v] = first; }
+      return;
+    }
+    auto subgraph = GetSubgraph(vertices);
+    int n_left = n / 2;
+    auto target = static_cast<double>(subgraph.GetTotalWeight()) * n_left / n;
+    auto sides = subgraph.Bisect(target, imbalance, random);
+    auto left = std::vector<int>(), right = std::vector<int>();
+    for (int i = 0; i != subgraph.CountVertices(); ++i) {
+      (sides[i] ? right : left).emplace_back(vertices[i]);
+    }
+    Partition(left, first, n_left, imbalance, random, parts);
+    Partition(right, first + n_left, n - n_left, imbalance, random, parts);
+  }
+  Graph GetSubgraph(std::vector<int> const& vertices) const {
+    auto old_to_new = std::vector<int>(CountVertices(), -1);
+    auto weights = std::vector<Weight>();
+    for (auto v : vertices) {
+      old_to_new[v] = weights.size();
+      weights.emplace_back(vertex_weights_[v]);
+    }
+    auto edges = std::vector<Edge>();
+    for (auto v : vertices) {
+      ForEachNeighbor(v, [&](int u, Weight w) {
+        if (v < u && old_to_new[u] >= 0) {
+          edges.push_back({old_to_new[v], old_to_new[u], w});
+        }
+      });
+    }
+    return Graph(std::move(weights), edges);
+  }
+  // Return side (0 or 1) of each vertex, where side 0 weighs about target:
+  std::vector<int> Bisect(double target, double imbalance,
+                          std::mt19937* random) const {
+    std::vector<int> sides;
+    if (CountVertices() <= kCoarsestSize) {
+      sides = GrowBisection(target, imbalance, random);
+    } else {
+      auto fine_to_coarse = std::vector<int>();
+      auto coarse = Coarsen(&fine_to_coarse);
+      if (coarse.CountVertices() > CountVertices() * 0.9) {
+        sides = GrowBisection(target, imbalance, random);
+      } else {
+        auto coarse_sides = coarse.Bisect(target, imbalance, random);
+        sides.resize(CountVertices());
+        for (int v = 0; v != CountVertices(); ++v) {
+          sides[v] = coarse_sides[fine_to_coarse[v]];
+        }
+      }
+    }
+    Refine(target, imbalance, &sides);
+    return sides;
+  }
+  // Merge each vertex with its unmatched neighbor along the heaviest edge.
+  // Vertices are visited in their own order, which keeps the locality of a
+  // mesh's numbering and gives more regular coarse graphs than a random one.
+  Graph Coarsen(std::vector<int>* fine_to_coarse) const {
+    int n = CountVertices();
+    auto& coarse_of = *fine_to_coarse;
+    coarse_of.assign(n, -1);
+    auto weights = std::vector<Weight>();
+    for (int v = 0; v != n; ++v) {
+      if (coarse_of[v] >= 0) { continue; }
+      int mate = -1;
+      Weight heaviest = 0;
+      ForEachNeighbor(v, [&](int u, Weight w) {
+        if (coarse_of[u] < 0 && w > heaviest) {
+          mate = u;
+          heaviest = w;
+        }
+      });
+      coarse_of[v] = weights.size();
+      weights.emplace_back(vertex_weights_[v]);
+      if (mate >= 0) {
+        coarse_of[mate] = coarse_of[v];
+        weights.back() += vertex_weights_[mate];
+      }
+    }
+    // Group fine vertices by their coarse vertex:
+    int n_coarse = weights.size();
+    auto begin = std::vector<int>(n_coarse + 1, 0);
+    for (int v = 0; v != n; ++v) { ++begin[coarse_of[v] + 1]; }
+    std::partial_sum(begin.begin(), begin.end(), begin.begin());
+    auto fines = std::vector<int>(n);
+    auto next = std::vector<int>(begin.begin(), begin.end() - 1);
+    for (int v = 0; v != n; ++v) { fines[next[coarse_of[v]]++] = v; }
+    // Merge parallel edges:
+    auto edges = std::vector<Edge>();
+    auto slot = std::vector<int>(n_coarse, -1);
+    for (int c = 0; c != n_coarse; ++c) {
+      int first = edges.size();
+      for (int k = begin[c]; k != begin[c + 1]; ++k) {
+        ForEachNeighbor(fines[k], [&](int u, Weight w) {
+          auto d = coarse_of[u];
+          if (d <= c) { return; }
+          if (slot[d] < first) {
+            slot[d] = edges.size();
+            edges.push_back({c, d, w});
+          } else {
+            edges[slot[d]].weight += w;
+          }
+        });
+      }
+    }
+    return Graph(std::move(weights), edges);
+  }
+  // Grow side 0 from several seeds by BFS, and keep the one of minimal cut:
+  std::vector<int> GrowBisection(double target, double imbalance,
+                                 std::mt19937* random) const {
+    int n = CountVertices();
+    auto best = std::vector<int>(n, 1);
+    if (n == 0) { return best; }
+    auto best_cut = -1;
+    auto pick = std::uniform_int_distribution<int>(0, n - 1);
+    for (int trial = 0; trial != kInitialTrials; ++trial) {
+      auto sides = std::vector<int>(n, 1);
+      Weight weight = 0;
+      auto queue = std::queue<int>();
+      int next_unvisited = 0;
+      auto seed = pick(*random);
+      while (weight < target) {
+        if (queue.empty()) {  // Start (or restart in another component):
+          if (sides[seed] == 0) {
+            while (next_unvisited != n && sides[next_unvisited] == 0) {
+              ++next_unvisited;
+            }
+            if (next_unvisited == n) { break; }
+            seed = next_unvisited;
+          }
+          sides[seed] = 0;
+          weight += vertex_weights_[seed];
+          queue.push(seed);
+          continue;
+        }
+        auto v = queue.front();
+        queue.pop();
+        ForEachNeighbor(v, [&](int u, Weight w) {
+          if (sides[u] == 1 && weight < target) {
+            sides[u] = 0;
+            weight += vertex_weights_[u];
+            queue.push(u);
+          }
+        });
+      }
+      Refine(target, imbalance, &sides);
+      auto cut = GetCut(sides);
+      if (best_cut < 0 || cut < best_cut) {
+        best_cut = cut;
+        best = sides;
+      }
+    }
+    return best;
+  }
+  // Fiduccia-Mattheyses passes, with rollback to the best prefix of moves:
+  void Refine(double target, double imbalance, std::vector<int>* sides) const {
+    auto& side = *sides;
+    int n = CountVertices();
+    Weight total = GetTotalWeight();
+    double max_weight[2] = {
+      std::max(target * (1 + imbalance), target + 1.0),
+      std::max((total - target) * (1 + imbalance), total - target + 1.0)
+    };
+    Weight weight[2] = {0, 0};
+    for (int v = 0; v != n; ++v) { weight[side[v]] += vertex_weights_[v]; }
+    auto gain = std::vector<Weight>(n);
+    auto locked = std::vector<bool>(n);
+    for (int pass = 0; pass != kRefinementPasses; ++pass) {
+      using Entry = std::pair<Weight, int>;
+      auto heap = std::priority_queue<Entry>();
+      for (int v = 0; v != n; ++v) {
+        bool on_boundary = false;
+        gain[v] = GetGain(v, side, &on_boundary);
+        locked[v] = false;
+        if (on_boundary) { heap.emplace(gain[v], v); }
+      }
+      auto moves = std::vector<int>();
+      Weight cut_change = 0, best_change = 0;
+      std::size_t best_size = 0;
+      auto excess = [&]() {
+        return std::max(weight[0] - max_weight[0], 0.0) +
+               std::max(weight[1] - max_weight[1], 0.0);
+      };
+      auto best_excess = excess();
+      while (!heap.empty() && moves.size() - best_size < kMaxFruitlessMoves) {
+        auto g = heap.top().first, v = heap.top().second;
+        heap.pop();
+        if (locked[v] || g != gain[v]) { continue; }
+        auto from = side[v], to = 1 - from;
+        auto w_v = vertex_weights_[v];
+        // Only move into the lighter side when this side is overweight:
+        if (weight[to] + w_v > max_weight[to] &&
+            !(weight[from] > max_weight[from] && weight[to] < weight[from])) {
+          continue;
+        }
+        side[v] = to;
+        weight[from] -= w_v;
+        weight[to] += w_v;
+        locked[v] = true;
+        moves.emplace_back(v);
+        cut_change -= g;
+        ForEachNeighbor(v, [&](int u, Weight w) {
+          gain[u] += side[u] == to ? -2 * w : 2 * w;
+          if (!locked[u]) { heap.emplace(gain[u], u); }
+        });
+        auto e = excess();
+        if (e < best_excess || (e == best_excess && cut_change < best_change)) {
+          best_excess = e;
+          best_change = cut_change;
+          best_size = moves.size();
+        }
+      }
+      // Undo the moves after the best prefix:
+      while (moves.size() > best_size) {
+        auto v = moves.back();
+        moves.pop_back();
+        weight[side[v]] -= vertex_weights_[v];
+        side[v] = 1 - side[v];
+        weight[side[v]] += vertex_weights_[v];
+      }
+      if (best_size == 0) { break; }
+    }
+  }
+  Weight GetGain(int v, std::vector<int> const& side,
+                 bool* on_boundary) const {
+    Weight gain = 0;
+    ForEachNeighbor(v, [&](int u, Weight w) {
+      if (side[u] == side[v]) {
+        gain -= w;
+      } else {
+        gain += w;
+        *on_boundary = true;
+      }
+    });
+    return gain;
+  }
+
+ private:
+  std::vector<Weight> vertex_weights_;
+  std::vector<int> begin_;
+  std::vector<int> neighbors_;
+  std::vector<Weight> edge_weights_;
+};
+
+// Split the cells of a Mesh into balanced parts, which are linked by as few
+// walls as possible.
+template <class Mesh>
+class Partition {
+ public:
+  // Types:
+  using Wall = typename Mesh::Wall;
+  using Cell = typename Mesh::Cell;
+  // Constructors:
+  Partition(Mesh* mesh, int n_parts, double imbalance = 0.03)
+      : n_parts_(n_parts), cells_(n_parts), interior_walls_(n_parts),
+        boundary_walls_(n_parts), cut_walls_(n_parts) {
+    // Build the dual graph, whose vertices are cells and edges are walls:
+    auto cells = std::vector<Cell*>();
+    mesh->ForEachCell([&](Cell& cell) {
+      cell_to_part_.emplace(&cell, cells.size());
+      cells.emplace_back(&cell);
+    });
+    auto edges = std::vector<Graph::Edge>();
+    mesh->ForEachWall([&](Wall& wall) {
+      auto positive = wall.GetPositiveSide();
+      auto negative = wall.GetNegativeSide();
+      if (positive && negative) {
+        edges.push_back({cell_to_part_.at(positive),
+                         cell_to_part_.at(negative), 1});
+      }
+    });
+    auto parts = Graph(cells.size(), edges).Partition(n_parts, imbalance);
+    for (int i = 0; i != cells.size(); ++i) {
+      cell_to_part_[cells[i]] = parts[i];
+      cells_[parts[i]].emplace_back(cells[i]);
+    }
+    // Distribute walls:
+    mesh->ForEachWall([&](Wall& wall) {
+      auto positive = wall.GetPositiveSide();
+      auto negative = wall.GetNegativeSide();
+      if (positive && negative) {
+        auto p = GetPart(*positive), q = GetPart(*negative);
+        if (p == q) {
+          interior_walls_[p].emplace_back(&wall);
+        } else {
+          cut_walls_[p].emplace_back(&wall);
+          cut_walls_[q].emplace_back(&wall);
+          ++n_cut_walls_;
+        }
+      } else {
+        auto cell = positive ? positive : negative;
+        boundary_walls_[GetPart(*cell)].emplace_back(&wall);
+      }
+    });
+  }
+  // Accessors:
+  int CountParts() const { return n_parts_; }
+  int CountCutWalls() const { return n_cut_walls_; }
+  int GetPart(Cell const& cell) const { return cell_to_part_.at(&cell); }
+  std::vector<Cell*> const& GetCells(int part) const { return cells_[part]; }
+  // Walls whose two sides are both in this part:
+  std::vector<Wall*> const& GetInteriorWalls(int part) const {
+    return interior_walls_[part];
+  }
+  // Walls with only one side, which is in this part:
+  std::vector<Wall*> const& GetBoundaryWalls(int part) const {
+    return boundary_walls_[part];
+  }
+  // Walls between this part and another one:
+  std::vector<Wall*> const& GetCutWalls(int part) const {
+    return cut_walls_[part];
+  }
+
+ private:
+  int n_parts_;
+  int n_cut_walls_{0};
+  std::unordered_map<Cell const*, int> cell_to_part_;
+  std::vector<std::vector<Cell*>> cells_;
+  std::vector<std::vector<Wall*>> interior_walls_;
+  std::vector<std::vector<Wall*>> boundary_walls_;
+  std::vector<std::vector<Wall*>> cut_walls_;
+};
+
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_PARTITION_HPP_
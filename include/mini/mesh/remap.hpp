@@ -0,0 +1,226 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#ifndef MINI_MESH_REMAP_HPP_
+#define MINI_MESH_REMAP_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mini {
+namespace mesh {
+
+// Conservative remapping of cell averages from a source mesh onto another
+// mesh of the same domain, in which each target cell takes the average over
+// the source cells it overlaps, weighted by the areas of overlaps.  Source
+// cells are indexed by a uniform grid of buckets, so each target cell only
+// clips the (convex) source cells in the buckets touched by its bounding box.
+template <class Mesh>
+class Remap {
+  using Cell = typename Mesh::Cell;
+  using Real = decltype(std::declval<typename Mesh::Node>().X());
+
+ public:
+  // Types:
+  using Point = std::array<Real, 2>;
+  using Polygon = std::vector<Point>;  // counterclockwise
+  // Constructors, which throw `std::invalid_argument` if `source` has no
+  // cell, or if its bounding box has no area:
+  explicit Remap(Mesh const& source) {
+    source.ForEachCell([&](Cell const& cell) {
+      cells_.emplace_back(&cell);
+      polygons_.emplace_back(GetPolygon(cell));
+      boxes_.emplace_back(GetBox(polygons_.back()));
+    });
+    if (cells_.empty()) {
+      throw std::invalid_argument("The source of `Remap` has no cell.");
+    }
+    box_ = boxes_[0];
+    for (auto& box : boxes_) {
+      box_[0] = std::min(box_[0], box[0]);
+      box_[1] = std::min(box_[1], box[1]);
+      box_[2] = std::max(box_[2], box[2]);
+      box_[3] = std::max(box_[3], box[3]);
+    }
+    // About one cell per bucket:
+    auto width = box_[2] - box_[0], height = box_[3] - box_[1];
+    if (!(width > 0 && height > 0)) {
+      throw std::invalid_argument("The source of `Remap` has no area.");
+    }
+    auto size = std::sqrt(width * height / cells_.size());
+    n_columns_ = std::max(1, static_cast<int>(std::ceil(width / size)));
+    n_rows_ = std::max(1, static_cast<int>(std::ceil(height / size)));
+    bucket_width_ = width / n_columns_;
+    bucket_height_ = height / n_rows_;
+    first_.assign(n_columns_ * n_rows_ + 1, 0);
+    for (auto& box : boxes_) {
+      ForEachBucket(box, [&](int b) { ++first_[b + 1]; });
+    }
+    for (int b = 0; b + 1 != first_.size(); ++b) { first_[b + 1] += first_[b]; }
+    buckets_.resize(first_.back());
+    auto next = std::vector<int>(first_.begin(), first_.end() - 1);
+    for (int i = 0; i != boxes_.size(); ++i) {
+      ForEachBucket(boxes_[i], [&](int b) { buckets_[next[b]++] = i; });
+    }
+  }
+  // Accessors:
+  int CountBuckets() const { return n_columns_ * n_rows_; }
+  // Call `visitor(source_cell, area)` for each source cell overlapping the
+  // `target` cell by a positive area:
+  template <class Target, class Visitor>
+  void ForEachOverlap(Target const& target, Visitor&& visitor) const {
+    auto polygon = GetPolygon(target);
+    auto box = GetBox(polygon);
+    auto candidates = std::vector<int>();
+    ForEachBucket(box, [&](int b) {
+      candidates.insert(candidates.end(), buckets_.begin() + first_[b],
+                        buckets_.begin() + first_[b + 1]);
+    });
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()),
+                     candidates.end());
+    for (auto i : candidates) {
+      auto& that = boxes_[i];
+      if (that[0] > box[2] || that[2] < box[0] ||
+          that[1] > box[3] || that[3] < box[1]) { continue; }
+      auto area = GetArea(Clip(polygon, polygons_[i]));
+      if (area > 0) { visitor(*cells_[i], area); }
+    }
+  }
+  // The average of `get(source_cell)` over the `target` cell, in which the
+  // parts of the target out of the source mesh (e.g. beyond a curved
+  // boundary) are ignored.  A target overlapping no source cell takes the
+  // value of the source cell nearest to its center:
+  template <class Target, class Getter>
+  auto GetAverage(Target const& target, Getter&& get) const {
+    using Value = std::decay_t<decltype(get(*cells_[0]))>;
+    auto sum = Value{};
+    auto covered = Real{0};
+    ForEachOverlap(target, [&](Cell const& source, Real area) {
+      auto value = Value(get(source));
+      value *= area;
+      sum += value;
+      covered += area;
+    });
+    if (covered > 0) {
+      sum /= covered;
+      return sum;
+    }
+    return Value(get(*cells_[FindNearest(target.Center())]));
+  }
+  // Geometric methods:
+  template <class AnyCell>
+  static Polygon GetPolygon(AnyCell const& cell) {
+    auto polygon = Polygon();
+    for (int i = 0; i != cell.CountVertices(); ++i) {
+      auto p = cell.GetPoint(i);
+      polygon.push_back({p->X(), p->Y()});
+    }
+    if (GetSignedArea(polygon) < 0) {
+      std::reverse(polygon.begin(), polygon.end());
+    }
+    return polygon;
+  }
+  static Real GetArea(Polygon const& polygon) {
+    return std::abs(GetSignedArea(polygon));
+  }
+  // The intersection of two convex polygons, by clipping `subject` with each
+  // edge of `clipper` (Sutherland-Hodgman):
+  static Polygon Clip(Polygon const& subject, Polygon const& clipper) {
+    auto output = subject;
+    for (int k = 0; k != clipper.size() && !output.empty(); ++k) {
+      auto& a = clipper[k];
+      auto& b = clipper[(k + 1) % clipper.size()];
+      // Positive on the left (inner) side of a -> b:
+      auto side = [&](Point const& p) {
+        return (b[0] - a[0]) * (p[1] - a[1]) - (b[1] - a[1]) * (p[0] - a[0]);
+      };
+      auto input = std::move(output);
+      output.clear();
+      for (int i = 0; i != input.size(); ++i) {
+        auto& p = input[i];
+        auto& q = input[(i + 1) % input.size()];
+        auto s_p = side(p), s_q = side(q);
+        if (s_p >= 0) { output.push_back(p); }
+        if ((s_p >= 0) != (s_q >= 0)) {
+          auto t = s_p / (s_p - s_q);
+          output.push_back({p[0] + t * (q[0] - p[0]),
+                            p[1] + t * (q[1] - p[1])});
+        }
+      }
+    }
+    return output;
+  }
+
+ private:
+  using Box = std::array<Real, 4>;  // (x_min, y_min, x_max, y_max)
+  static Real GetSignedArea(Polygon const& polygon) {
+    auto area = Real{0};
+    for (int i = 0; i != polygon.size(); ++i) {
+      auto& p = polygon[i];
+      auto& q = polygon[(i + 1) % polygon.size()];
+      area += p[0] * q[1] - q[0] * p[1];
+    }
+    return area / 2;
+  }
+  static Box GetBox(Polygon const& polygon) {
+    auto box = Box{polygon[0][0], polygon[0][1],
+                   polygon[0][0], polygon[0][1]};
+    for (auto& p : polygon) {
+      box[0] = std::min(box[0], p[0]);
+      box[1] = std::min(box[1], p[1]);
+      box[2] = std::max(box[2], p[0]);
+      box[3] = std::max(box[3], p[1]);
+    }
+    return box;
+  }
+  // Call `visitor(b)` for each bucket `b` touched by `box`:
+  template <class Visitor>
+  void ForEachBucket(Box const& box, Visitor&& visitor) const {
+    auto clamp = [](Real x, int n) {
+      return std::clamp(static_cast<int>(std::floor(x)), 0, n - 1);
+    };
+    int i_min = clamp((box[0] - box_[0]) / bucket_width_, n_columns_);
+    int i_max = clamp((box[2] - box_[0]) / bucket_width_, n_columns_);
+    int j_min = clamp((box[1] - box_[1]) / bucket_height_, n_rows_);
+    int j_max = clamp((box[3] - box_[1]) / bucket_height_, n_rows_);
+    for (int j = j_min; j <= j_max; ++j) {
+      for (int i = i_min; i <= i_max; ++i) { visitor(j * n_columns_ + i); }
+    }
+  }
+  // By brute force, as it only serves cells out of the source mesh:
+  template <class Center>
+  int FindNearest(Center const& center) const {
+    int nearest = 0;
+    auto min_distance = std::numeric_limits<Real>::max();
+    for (int i = 0; i != cells_.size(); ++i) {
+      auto that = cells_[i]->Center();
+      auto dx = that.X() - center.X(), dy = that.Y() - center.Y();
+      auto distance = dx * dx + dy * dy;
+      if (distance < min_distance) {
+        min_distance = distance;
+        nearest = i;
+      }
+    }
+    return nearest;
+  }
+
+  std::vector<Cell const*> cells_;
+  std::vector<Polygon> polygons_;
+  std::vector<Box> boxes_;
+  Box box_;
+  int n_columns_{0}, n_rows_{0};
+  Real bucket_width_{1}, bucket_height_{1};
+  std::vector<int> first_;  // buckets in CSR form
+  std::vector<int> buckets_;
+};
+
+}  // namespace mesh
+}  // namespace mini
+
+#endif  // MINI_MESH_REMAP_HPP_
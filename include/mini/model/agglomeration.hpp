@@ -0,0 +1,87 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_AGGLOMERATION_HPP_
+#define MINI_MODEL_AGGLOMERATION_HPP_
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "mini/model/multigrid.hpp"
+#include "mini/model/steady.hpp"
+#include "mini/model/sweep.hpp"
+
+namespace mini {
+namespace model {
+
+// Multigrid cycles on a mesh, whose finest level is made of the walls in a
+// Sweep, and whose ghosts are kept as boundary faces, so coarse levels can
+// make their own ghosts.
+template <class Mesh, class Riemann>
+class Agglomeration {
+  using Cell = typename Mesh::Cell;
+  using State = typename Riemann::State;
+  using Sweep = model::Sweep<Mesh, Riemann>;
+  using Multigrid = model::Multigrid<Riemann>;
+  static constexpr int kComponents = sizeof(State) / sizeof(double);
+
+ public:
+  // Constructors:
+  Agglomeration() = default;
+  Agglomeration(int n_levels, int gamma, int n_smoothings)
+      : multigrid_(n_levels, gamma, n_smoothings) {}
+  // Accessors:
+  bool IsEnabled() const { return multigrid_.IsEnabled(); }
+  // Mutators:
+  // Build all levels on the cells (of `measures`) linked by `sweep`, and
+  // print their sizes:
+  void Build(Sweep const& sweep, std::vector<double> const& measures) {
+    using Face = typename Multigrid::Face;
+    using Kind = typename Multigrid::Kind;
+    auto faces = std::vector<Face>();
+    int n_walls = sweep.CountWalls();
+    for (int i = 0; i != n_walls; ++i) {
+      auto wall = sweep.GetWall(i);
+      auto length = wall->Measure();
+      auto kind = Kind::kTwoSided;
+      if (auto ghost = sweep.GetGhost(i)) {
+        kind = ghost->is_solid ? Kind::kSolid : Kind::kFree;
+      }
+      faces.push_back({wall->data.riemann,
+                       (wall->Tail()->Y() - wall->Head()->Y()) / length,
+                       (wall->Head()->X() - wall->Tail()->X()) / length,
+                       length, sweep.GetCells(i).first,
+                       sweep.GetCells(i).second, kind});
+    }
+    multigrid_.Build(measures, std::move(faces));
+    std::printf("Multigrid levels (cells):");
+    for (int l = 0; l != multigrid_.CountLevels(); ++l) {
+      std::printf(" %d", multigrid_.CountCells(l));
+    }
+    std::printf("\n");
+  }
+  // Run one cycle of `cfl` on `cells`, whose d(state)/dt at the start is
+  // given to `steady` (if not nullptr):
+  void Advance(std::vector<Cell*> const& cells, double cfl,
+               Steady<kComponents>* steady) {
+    int n = cells.size();
+    states_.resize(n);
+    for (int i = 0; i != n; ++i) { states_[i] = cells[i]->data.state; }
+    multigrid_.Cycle(&states_, cfl);
+    for (int i = 0; i != n; ++i) { cells[i]->data.state = states_[i]; }
+    if (steady) {
+      for (auto& rate : multigrid_.GetFineRates()) { steady->Add(rate); }
+    }
+    if (auto factor = multigrid_.GetConvergenceFactor()) {
+      std::printf("Multigrid: convergence factor = %g\n", factor);
+    }
+  }
+
+ private:
+  Multigrid multigrid_;
+  std::vector<State> states_;  // in the order of cells
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_AGGLOMERATION_HPP_
@@ -4,6 +4,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -20,6 +23,7 @@ class Manager {
   // Types:
   using Wall = typename Mesh::Wall;
   using Part = std::vector<Wall*>;
+  using Predicate = std::function<bool(Wall&)>;
   // Mutators:
   void AddInteriorWall(Wall* wall) {
     interior_walls_.emplace_back(wall);
@@ -27,33 +31,65 @@ class Manager {
   void AddBoundaryWall(Wall* wall) {
     boundary_walls_.emplace_back(wall);
   }
-  template <class Visitor>
-  void SetBoundaryName(std::string const& name, Visitor&& visitor) {
-    name_to_part_.emplace(name, std::make_unique<Part>());
-    auto& part = name_to_part_[name];
-    for (auto& wall : boundary_walls_) {
-      if (visitor(*wall)) {
-        part->emplace_back(wall);
+  // Boundary walls tagged by the mesh file (e.g. by physical groups):
+  void AddBoundaryWall(Wall* wall, int tag) {
+    boundary_walls_.emplace_back(wall);
+    wall_to_tag_.emplace(wall, tag);
+  }
+  // Name boundary walls by (name, predicate) pairs, whose predicates are all
+  // evaluated here in one pass over the boundary walls added so far (so they
+  // may capture locals by reference), and a wall claimed twice throws.  Only
+  // the claims are kept until ClearBoundaryCondition() sorts all walls into
+  // parts:
+  void SetBoundaryNames(
+      std::vector<std::pair<std::string, Predicate>> const& named_predicates) {
+    auto owners = std::vector<std::string const*>();
+    for (auto& [name, predicate] : named_predicates) {
+      owners.emplace_back(AddName(name));
+    }
+    int n = boundary_walls_.size();
+    int n_names = named_predicates.size();
+    owners_.resize(n);
+    for (int i = 0; i != n; ++i) {
+      auto& wall = *boundary_walls_[i];
+      for (int k = 0; k != n_names; ++k) {
+        if (named_predicates[k].second(wall)) {
+          Claim(wall, owners[k], &owners_[i]);
+        }
       }
     }
   }
+  template <class Function>
+  void SetBoundaryName(std::string const& name, Function&& predicate) {
+    SetBoundaryNames({{name, std::forward<Function>(predicate)}});
+  }
+  void SetBoundaryTag(std::string const& name, int tag) {
+    tag_to_name_.emplace(tag, AddName(name));
+  }
   void SetPeriodicBoundary(std::string const& head, std::string const& tail) {
-    periodic_part_pairs_.emplace_back(name_to_part_[head].get(),
-                                      name_to_part_[tail].get());
-    SetPeriodicBoundary(name_to_part_[head].get(), name_to_part_[tail].get());
+    periodic_name_pairs_.emplace_back(head, tail);
   }
   void SetFreeBoundary(std::string const& name) {
-    free_parts_.emplace_back(name_to_part_[name].get());
+    free_names_.emplace_back(name);
   }
   void SetSolidBoundary(std::string const& name) {
-    solid_parts_.emplace_back(name_to_part_[name].get());
+    solid_names_.emplace_back(name);
   }
+  // Classify boundary walls, and merge each pair of periodic walls into one
+  // interior wall:
   void ClearBoundaryCondition() {
-    if (CheckBoundaryConditions()) {
-      boundary_walls_.clear();
-    } else {
-      throw std::length_error("Some `Wall`s do not have BC info.");
+    ClassifyBoundaryWalls();
+    for (auto& name : free_names_) {
+      free_parts_.emplace_back(GetPart(name));
+    }
+    for (auto& name : solid_names_) {
+      solid_parts_.emplace_back(GetPart(name));
+    }
+    for (auto& [head, tail] : periodic_name_pairs_) {
+      SetPeriodicBoundary(GetPart(head), GetPart(tail));
     }
+    boundary_walls_.clear();
+    wall_to_tag_.clear();
   }
   // Iterators:
   template<class Visitor>
@@ -63,15 +99,6 @@ class Manager {
     }
   }
   template<class Visitor>
-  void ForEachPeriodicWall(Visitor&& visit) {
-    for (auto& [left, right] : periodic_part_pairs_) {
-      for (int i = 0; i < left->size(); i++) {
-        visit(left->at(i));
-        right->at(i)->data.flux = left->at(i)->data.flux;
-      }
-    }
-  }
-  template<class Visitor>
   void ForEachFreeWall(Visitor&& visit) {
     for (auto& part : free_parts_) {
       for (auto& wall : *part) {
@@ -94,55 +121,152 @@ class Manager {
   std::vector<Wall*> boundary_walls_;
   std::vector<Part*> free_parts_;
   std::vector<Part*> solid_parts_;
-  std::vector<std::pair<Part*, Part*>> periodic_part_pairs_;
   std::unordered_map<std::string, std::unique_ptr<Part>> name_to_part_;
+  // Boundary conditions to be applied in ClearBoundaryCondition():
+  std::vector<std::string const*> owners_;  // of boundary_walls_ by names
+  std::unordered_map<int, std::string const*> tag_to_name_;
+  std::unordered_map<Wall const*, int> wall_to_tag_;
+  std::vector<std::string> free_names_;
+  std::vector<std::string> solid_names_;
+  std::vector<std::pair<std::string, std::string>> periodic_name_pairs_;
   // Implement details:
+  // Match walls by hashing their centers, in which tail centers are shifted
+  // by the offset between the centroids of the two parts.  Two walls match if
+  // their shifted centers are closer than a quarter of the shortest wall, and
+  // each tail wall matches at most one head wall.
   void SetPeriodicBoundary(Part* head, Part* tail) {
-    assert(head->size() == tail->size());
-    auto cmp = [](Wall* a, Wall* b) {
-      auto point_a = a->Center();
-      auto point_b = b->Center();
-      if (point_a.Y() != point_b.Y()) {
-        return point_a.Y() < point_b.Y();
-      } else {
-        return point_a.X() < point_b.X();
-      }
+    if (head->size() != tail->size()) {
+      throw std::length_error("Periodic parts differ in size.");
+    }
+    auto head_centroid = GetCentroid(*head);
+    auto tail_centroid = GetCentroid(*tail);
+    auto head_x = head_centroid.first, head_y = head_centroid.second;
+    auto tail_x = tail_centroid.first, tail_y = tail_centroid.second;
+    auto min_length = std::numeric_limits<double>::max();
+    for (auto wall : *tail) {
+      min_length = std::min(min_length, static_cast<double>(wall->Measure()));
+    }
+    auto tolerance = min_length / 4;
+    // Shifted as unsigned, since `i` may be negative:
+    auto get_key = [tolerance](double x, double y, int dx, int dy) {
+      auto i = static_cast<std::int64_t>(std::floor(x / tolerance)) + dx;
+      auto j = static_cast<std::int64_t>(std::floor(y / tolerance)) + dy;
+      return (static_cast<std::uint64_t>(i) << 32) ^
+             (static_cast<std::uint64_t>(j) & 0xffffffff);
     };
-    std::sort(head->begin(), head->end(), cmp);
-    std::sort(tail->begin(), tail->end(), cmp);
-    for (int i = 0; i < head->size(); i++) {
-      SewMatchingWalls(head->at(i), tail->at(i));
-    }
-  }
-  void SewMatchingWalls(Wall* a, Wall* b) {
-    auto left___in = a->GetPositiveSide();
-    auto right__in = a->GetNegativeSide();
-    auto left__out = b->GetPositiveSide();
-    auto right_out = b->GetNegativeSide();
-    if (left___in == nullptr) {
-      if (left__out == nullptr) {
-        a->SetPositiveSide(right_out);
-        b->SetPositiveSide(right__in);
-      } else {
-        a->SetPositiveSide(left__out);
-        b->SetNegativeSide(right__in);
+    using Key = std::uint64_t;
+    auto key_to_walls = std::unordered_map<Key, std::vector<Wall*>>();
+    for (auto wall : *tail) {
+      auto center = wall->Center();
+      auto x = center.X() - tail_x, y = center.Y() - tail_y;
+      key_to_walls[get_key(x, y, 0, 0)].emplace_back(wall);
+    }
+    for (auto a : *head) {
+      auto center = a->Center();
+      auto x = center.X() - head_x, y = center.Y() - head_y;
+      std::vector<Wall*>* bucket = nullptr;  // holding the match
+      int i_match = -1;
+      auto min_distance = tolerance;
+      for (int dx = -1; dx <= 1; ++dx) {
+        for (int dy = -1; dy <= 1; ++dy) {
+          auto iter = key_to_walls.find(get_key(x, y, dx, dy));
+          if (iter == key_to_walls.end()) { continue; }
+          int n = iter->second.size();
+          for (int i = 0; i != n; ++i) {
+            auto that = iter->second[i]->Center();
+            auto distance = std::hypot(that.X() - tail_x - x,
+                                       that.Y() - tail_y - y);
+            if (distance < min_distance) {
+              min_distance = distance;
+              bucket = &iter->second;
+              i_match = i;
+            }
+          }
+        }
       }
-    } else {
-      if (left__out == nullptr) {
-        a->SetNegativeSide(right_out);
-        b->SetPositiveSide(left___in);
-      } else {
-        a->SetNegativeSide(left__out);
-        b->SetNegativeSide(left___in);
+      if (bucket == nullptr) {
+        throw std::invalid_argument("A periodic `Wall` has no match.");
       }
+      // A matched tail wall is used up:
+      auto b = (*bucket)[i_match];
+      (*bucket)[i_match] = bucket->back();
+      bucket->pop_back();
+      MergeMatchingWalls(a, b);
+    }
+  }
+  static std::pair<double, double> GetCentroid(Part const& part) {
+    auto x = 0.0, y = 0.0;
+    for (auto wall : part) {
+      auto center = wall->Center();
+      x += center.X();
+      y += center.Y();
+    }
+    return {x / part.size(), y / part.size()};
+  }
+  // Let `a` take the place of `b` in the only cell of `b`, so that fluxes
+  // on each pair are computed and stored only once:
+  void MergeMatchingWalls(Wall* a, Wall* b) {
+    auto cell_b = b->GetPositiveSide() ? b->GetPositiveSide()
+                                       : b->GetNegativeSide();
+    if (a->GetPositiveSide() == nullptr) {
+      a->SetPositiveSide(cell_b);
+    } else {
+      a->SetNegativeSide(cell_b);
+    }
+    cell_b->ReplaceWall(b, a);
+    interior_walls_.emplace_back(a);
+  }
+  // Keys of `name_to_part_` are stable, so they serve as owners of walls:
+  std::string const* AddName(std::string const& name) {
+    auto result = name_to_part_.emplace(name, std::make_unique<Part>());
+    if (!result.second) {
+      throw std::invalid_argument("`" + name + "` is already used.");
     }
+    return &result.first->first;
   }
-  bool CheckBoundaryConditions() {
-    int n = 0;
-    for (auto& [name, part] : name_to_part_) {
-      n += part->size();
+  Part* GetPart(std::string const& name) const {
+    auto iter = name_to_part_.find(name);
+    if (iter == name_to_part_.end()) {
+      throw std::invalid_argument("`" + name + "` is not a boundary name.");
     }
-    return n == boundary_walls_.size();
+    return iter->second.get();
+  }
+  // Each boundary wall must be claimed by exactly one name:
+  static void Claim(Wall const& wall, std::string const* name,
+                    std::string const** owner) {
+    if (*owner) {
+      throw std::length_error("A `Wall` centered at " + ToString(wall) +
+                              " is claimed by both `" + **owner +
+                              "` and `" + *name + "`.");
+    }
+    *owner = name;
+  }
+  void ClassifyBoundaryWalls() {
+    for (auto& [name, part] : name_to_part_) { part->clear(); }
+    int n = boundary_walls_.size();
+    owners_.resize(n);
+    for (int i = 0; i != n; ++i) {
+      auto wall = boundary_walls_[i];
+      auto& owner = owners_[i];
+      auto tag = wall_to_tag_.find(wall);
+      if (tag != wall_to_tag_.end()) {
+        auto name = tag_to_name_.find(tag->second);
+        if (name != tag_to_name_.end()) {
+          Claim(*wall, name->second, &owner);
+        }
+      }
+      if (owner == nullptr) {
+        throw std::length_error("A `Wall` centered at " + ToString(*wall) +
+                                " is not claimed by any name.");
+      }
+      name_to_part_[*owner]->emplace_back(wall);
+    }
+    owners_.clear();
+  }
+  static std::string ToString(Wall const& wall) {
+    auto center = wall.Center();
+    return "(" + std::to_string(center.X()) + ", " +
+           std::to_string(center.Y()) + ")";
   }
 };
 
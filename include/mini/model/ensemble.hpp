@@ -0,0 +1,172 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_ENSEMBLE_HPP_
+#define MINI_MODEL_ENSEMBLE_HPP_
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mini/model/boundary.hpp"
+#include "mini/model/sweep.hpp"
+
+namespace mini {
+namespace model {
+
+// Several initial conditions advanced on a shared mesh at once.  The states
+// of each cell are stored contiguously (member-innermost), so that each
+// wall's solver and geometry are loaded once for all members.
+template <class Mesh, class Riemann>
+class Ensemble {
+  using Wall = typename Mesh::Wall;
+  using Cell = typename Mesh::Cell;
+  using State = typename Riemann::State;
+  using Flux = typename Riemann::Flux;
+
+ public:
+  // Constructors:
+  Ensemble() = default;
+  // Copy the state of each cell into all its `n_members` members:
+  Ensemble(int n_members, std::vector<Cell*> const& cells)
+      : cells_(cells), n_members_(n_members) {
+    int n_cells = cells_.size();
+    members_.resize(n_cells * n_members);
+    for (int i = 0; i != n_cells; ++i) {
+      for (int m = 0; m != n_members; ++m) {
+        members_[i * n_members + m] = cells_[i]->data.state;
+      }
+    }
+  }
+  // Accessors:
+  bool IsEnabled() const { return n_members_ > 0; }
+  int CountMembers() const { return n_members_; }
+  State const& GetState(int i_cell, int member) const {
+    return members_[i_cell * n_members_ + member];
+  }
+  // All states, i.e. `GetState(i_cell, member)` at [i_cell * n + member]:
+  std::vector<State> const& GetStates() const { return members_; }
+  // Mutators:
+  // Set the state of each member by `visitor(cell, member)`:
+  template <class Visitor>
+  void SetInitialStates(Visitor&& visitor) {
+    int n_cells = cells_.size();
+    for (int i = 0; i != n_cells; ++i) {
+      for (int m = 0; m != n_members_; ++m) {
+        members_[i * n_members_ + m] = visitor(*cells_[i], m);
+      }
+    }
+  }
+  void SetStates(std::vector<State> const& states) { members_ = states; }
+  // Link each wall to the cells on its sides, and each cell to its walls:
+  void Link(Manager<Mesh>* manager,
+            std::unordered_map<Cell const*, int> const& cell_to_index) {
+    walls_.clear();
+    auto wall_to_index = std::unordered_map<Wall const*, int>();
+    auto add = [&](Wall* wall, bool is_solid) {
+      wall_to_index.emplace(wall, walls_.size());
+      auto& link = walls_.emplace_back();
+      link.wall = wall;
+      link.is_solid = is_solid;
+      if (wall->GetPositiveSide()) {
+        link.positive = cell_to_index.at(wall->GetPositiveSide());
+      }
+      if (wall->GetNegativeSide()) {
+        link.negative = cell_to_index.at(wall->GetNegativeSide());
+      }
+    };
+    manager->ForEachInteriorWall([&](Wall* wall) { add(wall, false); });
+    manager->ForEachFreeWall([&](Wall* wall) { add(wall, false); });
+    manager->ForEachSolidWall([&](Wall* wall) { add(wall, true); });
+    fluxes_.resize(walls_.size() * n_members_);
+    first_wall_ = {0};
+    cell_walls_.clear();
+    measures_.clear();
+    for (auto cell : cells_) {
+      cell->ForEachWall([&](Wall& wall) {
+        auto sign = wall.GetPositiveSide() == cell ? -1 : +1;
+        cell_walls_.emplace_back(wall_to_index.at(&wall), sign);
+      });
+      first_wall_.emplace_back(cell_walls_.size());
+      measures_.emplace_back(cell->Measure());
+    }
+  }
+  // Advance all members by an explicit step:
+  void Advance(double step_size) {
+    auto n = n_members_;
+    int n_walls = walls_.size();
+    for (int w = 0; w != n_walls; ++w) {
+      auto& link = walls_[w];
+      auto& riemann = link.wall->data.riemann;
+      auto measure = link.wall->Measure();
+      auto fluxes = &fluxes_[w * n];
+      if (link.positive >= 0 && link.negative >= 0) {
+        auto u_l = &members_[link.positive * n];
+        auto u_r = &members_[link.negative * n];
+        for (int m = 0; m != n; ++m) {
+          fluxes[m] = riemann.GetFluxOnTimeAxis(u_l[m], u_r[m]);
+          fluxes[m] *= measure;
+        }
+        continue;
+      }
+      // A boundary wall, whose ghost states are made on the fly:
+      auto inner = &members_[std::max(link.positive, link.negative) * n];
+      for (int m = 0; m != n; ++m) {
+        fluxes[m] = Sweep<Mesh, Riemann>::GetFluxOnBoundary(
+            &riemann, inner[m], link.is_solid, link.positive >= 0);
+        fluxes[m] *= measure;
+      }
+    }
+    auto net_fluxes = std::vector<Flux>(n);
+    int n_cells = cells_.size();
+    for (int i = 0; i != n_cells; ++i) {
+      std::fill(net_fluxes.begin(), net_fluxes.end(), Flux{});
+      for (int k = first_wall_[i]; k != first_wall_[i + 1]; ++k) {
+        auto fluxes = &fluxes_[cell_walls_[k].first * n];
+        if (cell_walls_[k].second < 0) {
+          for (int m = 0; m != n; ++m) { net_fluxes[m] -= fluxes[m]; }
+        } else {
+          for (int m = 0; m != n; ++m) { net_fluxes[m] += fluxes[m]; }
+        }
+      }
+      auto states = &members_[i * n];
+      for (int m = 0; m != n; ++m) {
+        net_fluxes[m] /= measures_[i];
+        net_fluxes[m] *= step_size;
+        states[m] += net_fluxes[m];
+      }
+    }
+  }
+  // Put the mean of all members into each cell:
+  void ScatterMeans() const {
+    int n_cells = cells_.size();
+    for (int i = 0; i != n_cells; ++i) {
+      auto& mean = cells_[i]->data.state;
+      mean = members_[i * n_members_];
+      for (int m = 1; m != n_members_; ++m) {
+        mean += members_[i * n_members_ + m];
+      }
+      mean /= n_members_;
+    }
+  }
+
+ private:
+  struct MemberWall {
+    Wall* wall;
+    int positive{-1}, negative{-1};  // -1 for ghosts behind boundary walls
+    bool is_solid;
+  };
+  std::vector<Cell*> cells_;
+  int n_members_{0};
+  std::vector<State> members_;  // members_[i_cell * n_members_ + i_member]
+  std::vector<MemberWall> walls_;
+  std::vector<Flux> fluxes_;
+  std::vector<double> measures_;
+  // Walls of each cell (in CSR form), with the signs of their fluxes:
+  std::vector<int> first_wall_{0};
+  std::vector<std::pair<int, int>> cell_walls_;
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_ENSEMBLE_HPP_
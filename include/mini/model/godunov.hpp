@@ -3,12 +3,37 @@
 #ifndef MINI_MODEL_GODUNOV_HPP_
 #define MINI_MODEL_GODUNOV_HPP_
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
 #include <memory>
-#include <set>
+#include <stdexcept>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
+#include "mini/mesh/cache.hpp"
+#include "mini/mesh/gmsh.hpp"
+#include "mini/mesh/partition.hpp"
+#include "mini/mesh/remap.hpp"
 #include "mini/mesh/vtk.hpp"
+#include "mini/model/agglomeration.hpp"
 #include "mini/model/boundary.hpp"
+#include "mini/model/ensemble.hpp"
+#include "mini/model/implicit.hpp"
+#include "mini/model/linear.hpp"
+#include "mini/model/lu_sgs.hpp"
+#include "mini/model/residual.hpp"
+#include "mini/model/rollback.hpp"
+#include "mini/model/steady.hpp"
+#include "mini/model/subdomain.hpp"
+#include "mini/model/sweep.hpp"
+#include "mini/model/watchdog.hpp"
 
 namespace mini {
 namespace model {
@@ -21,24 +46,40 @@ class Godunov {
   using Flux = typename Riemann::Flux;
   using Reader = mesh::VtkReader<Mesh>;
   using Writer = mesh::VtkWriter<Mesh>;
+  using MeshCache = mesh::Cache<Mesh>;
+  static constexpr int kComponents = sizeof(State) / sizeof(double);
+  using Domain = Subdomain<Mesh, Riemann>;
+  using Bad = std::pair<Cell const*, int>;  // (cell, member) of a bad state
 
  public:
   explicit Godunov(std::string const& name) : model_name_(name) {}
   bool ReadMesh(std::string const& file_name) {
-    reader_ = Reader();
-    if (reader_.ReadFromFile(file_name)) {
-      mesh_ = reader_.GetMesh();
-      Preprocess();
-      return true;
-    } else {
-      return false;
+    auto wall_to_tag = std::unordered_map<Wall const*, int>();
+    auto tag_to_name = std::map<int, std::string>();
+    if (!LoadMesh(file_name, &wall_to_tag, &tag_to_name)) { return false; }
+    // Boundary walls in tagged groups need no SetBoundaryName():
+    for (auto& pair : tag_to_name) {
+      wall_manager_.SetBoundaryTag(pair.second, pair.first);
     }
+    Preprocess(wall_to_tag);
+    return true;
+  }
+  // Keep a binary image of each mesh read in `dir`, named by the hash of the
+  // mesh file, so that later runs on the same mesh skip parsing it.  It must
+  // be called before ReadMesh().
+  void UseMeshCache(std::string const& dir) {
+    cache_dir_ = dir;
   }
   // Mutators:
   template <class Visitor>
   void SetBoundaryName(std::string const& name, Visitor&& visitor) {
     wall_manager_.SetBoundaryName(name, visitor);
   }
+  // Name boundary walls by (name, predicate) pairs in one pass over them:
+  void SetBoundaryNames(std::vector<std::pair<
+      std::string, typename Manager<Mesh>::Predicate>> const& pairs) {
+    wall_manager_.SetBoundaryNames(pairs);
+  }
   void SetInletBoundary(std::string const& name) {
     wall_manager_.SetInletBoundary(name);
   }
@@ -59,6 +100,64 @@ class Godunov {
   void SetInitialState(Visitor&& visitor) {
     mesh_->ForEachCell(visitor);
   }
+  // Set the initial state by conservatively remapping the states on another
+  // mesh of the same domain, e.g. that of a coarser model which has run, so
+  // that a finer run starts without most of its transient.  It must be
+  // called after ReadMesh():
+  void RemapInitialState(Mesh const& source) {
+    auto remap = mesh::Remap<Mesh>(source);
+    mesh_->ForEachCell([&](Cell& cell) {
+      cell.data.state = remap.GetAverage(cell, [](Cell const& that) {
+        return that.data.state;
+      });
+    });
+  }
+  // Write a checkpoint of the current states, which is made of the states
+  // of all cells in `<file_name>.states` and a binary image of the mesh in
+  // `<file_name>.mesh` (keyed by the hash of the former), so that a run on
+  // any mesh can restart from it by ReadCheckpoint():
+  bool WriteCheckpoint(std::string const& file_name) const {
+    static_assert(std::is_trivially_copyable_v<State>);
+    if (UseEnsemble()) {
+      throw std::invalid_argument("`UseEnsemble()` has no checkpoints.");
+    }
+    auto states_name = file_name + ".states";
+    auto file = std::ofstream(states_name, std::ios::binary);
+    if (!file) { return false; }
+    auto n_cells = static_cast<std::uint64_t>(mesh_->CountCells());
+    file.write(reinterpret_cast<char const*>(&n_cells), sizeof(n_cells));
+    mesh_->ForEachCell([&](Cell const& cell) {
+      file.write(reinterpret_cast<char const*>(&cell.data.state),
+                 sizeof(State));
+    });
+    file.close();
+    if (!file) { return false; }
+    return MeshCache::WriteToFile(file_name + ".mesh",
+                                  MeshCache::Hash(states_name), *mesh_,
+                                  {}, {});
+  }
+  // Set the initial state by remapping that in a checkpoint, whose mesh may
+  // differ from this one.  It must be called after ReadMesh(), and returns
+  // false if the checkpoint is absent or broken:
+  bool ReadCheckpoint(std::string const& file_name) {
+    auto states_name = file_name + ".states";
+    auto cache = MeshCache();
+    if (!cache.ReadFromFile(file_name + ".mesh",
+                            MeshCache::Hash(states_name))) {
+      return false;
+    }
+    auto source = cache.GetMesh();
+    auto file = std::ifstream(states_name, std::ios::binary);
+    auto n_cells = std::uint64_t();
+    file.read(reinterpret_cast<char*>(&n_cells), sizeof(n_cells));
+    if (!file || n_cells != source->CountCells()) { return false; }
+    source->ForEachCell([&](Cell& cell) {
+      file.read(reinterpret_cast<char*>(&cell.data.state), sizeof(State));
+    });
+    if (!file) { return false; }
+    RemapInitialState(*source);
+    return true;
+  }
   void SetTimeSteps(double duration, int n_steps, int refresh_rate) {
     duration_ = duration;
     n_steps_ = n_steps;
@@ -68,35 +167,274 @@ class Godunov {
   void SetOutputDir(std::string dir) {
     dir_ = dir;
   }
-  // Major computation:
+  // Advance a linear model by a sparse matrix, which is assembled only once:
+  void UseSparseMatrix(int n_threads = 1) {
+    static_assert(Riemann::IsLinear());
+    use_sparse_matrix_ = true;
+    linear_ = Linear<Mesh, Riemann>(n_threads);
+  }
+  // Split the mesh into `n_parts` subdomains, each of which is advanced by
+  // its own thread and exchanges halo states with its neighbors once a step:
+  void UseSubdomains(int n_parts) {
+    assert(n_parts > 0);
+    n_subdomains_ = n_parts;
+  }
+  // Advance `n_members` initial conditions on the shared mesh at once.  The
+  // states of each cell are stored contiguously (member-innermost), so that
+  // one sweep of walls serves all members.  It must be called after
+  // ReadMesh(), and frames show the ensemble mean:
+  void UseEnsemble(int n_members) {
+    assert(n_members > 0 && mesh_);
+    IndexCells();
+    ensemble_ = Ensemble<Mesh, Riemann>(n_members, cells_);
+  }
+  // Set the state of each member by `visitor(cell, member)`:
+  template <class Visitor>
+  void SetInitialStates(Visitor&& visitor) {
+    ensemble_.SetInitialStates(visitor);
+  }
+  // Check all states every `period` steps (or at each frame if subdomains are
+  // used).  On any non-finite or inadmissible state, the run is rolled back
+  // if SetRollback() is called, or stopped by throwing a `Blowup`, whose
+  // message reports up to `max_reports` offending cells with their
+  // coordinates and neighbors:
+  void SetWatchdog(int period, int max_reports = 8) {
+    watchdog_ = Watchdog<Riemann>(period, max_reports);
+  }
+  // Keep the last `n_snapshots` healthy states found by the watchdog.  On a
+  // failure, the run restarts from the latest one with the step size halved
+  // (at most `max_halvings` times, after which older snapshots are tried),
+  // and the nominal step size is restored later.  It excludes subdomains.
+  void SetRollback(int n_snapshots, int max_halvings = 4) {
+    rollback_ = Rollback<State>(n_snapshots, max_halvings);
+  }
+  // Run toward a steady state, in which `n_steps` of SetTimeSteps() is only an
+  // upper bound.  Residual norms of each step are logged in the file
+  // `<output_dir><model_name>.residual`, and the run stops once the L2 norm
+  // of every component drops below `tolerance` times its peak (so components
+  // starting from round-off are not overweighted), or once the largest such
+  // ratio has hit no new low in `stall_steps` steps (0 for never).  It
+  // excludes ensembles and subdomains.
+  void SetSteadyState(double tolerance, int stall_steps = 0) {
+    steady_ = Steady<kComponents>(tolerance, stall_steps);
+  }
+  Residual<kComponents> const& GetResidual() const {
+    return steady_.GetResidual();
+  }
+  // Advance each cell by its own pseudo-time step, which is `cfl` times the
+  // largest stable one of that cell, i.e. its area over the sum of (largest
+  // wave speed * length) of its walls.  Time is no longer uniform, so it only
+  // serves SetSteadyState(), and it excludes sparse matrices, ensembles and
+  // subdomains.
+  void UseLocalTimeSteps(double cfl) {
+    assert(cfl > 0);
+    local_cfl_ = cfl;
+  }
+  // Advance by backward Euler, i.e. solve (u' - u) / dt = R(u') for the new
+  // states u' by `n_newtons` Newton steps.  Each linear system is solved by
+  // GMRES to a relative `tolerance` in at most `n_krylov` iterations, where
+  // products with the Jacobian of R are finite differences of R itself, and
+  // the preconditioner is the inverse diagonal blocks (see also
+  // UseIluPreconditioner()) built from per-wall flux Jacobians.  It allows
+  // CFL numbers far beyond 1 (e.g. by UseLocalTimeSteps()), and excludes
+  // sparse matrices, ensembles and subdomains.
+  void UseImplicitSteps(int n_newtons, double tolerance = 1e-2,
+                        int n_krylov = 30) {
+    implicit_ = Implicit<Mesh, Riemann>(n_newtons, tolerance, n_krylov);
+  }
+  // Precondition implicit steps by the block ILU(0) of (I / dt - dR/du)
+  // instead of its block diagonal, which costs more memory and time per
+  // iteration, but saves GMRES iterations on stiff cases:
+  void UseIluPreconditioner() { use_ilu_ = true; }
+  // Advance by LU-SGS, which relaxes the backward Euler system once a step by
+  // a forward and a backward Gauss-Seidel sweep over cells.  Flux Jacobians
+  // are replaced by differences of normal fluxes and by spectral radii from
+  // Riemann::GetMaximumSpeed(), so nothing but one increment per cell is
+  // stored.  The spectral radii on the diagonal are scaled by `omega` (in
+  // [1, 2], larger for robustness).  It takes large CFL numbers by
+  // UseLocalTimeSteps(), and excludes implicit steps, sparse matrices,
+  // ensembles and subdomains.
+  void UseLuSgsSteps(double omega) {
+    lu_sgs_ = LuSgs<Mesh, Riemann>(omega);
+  }
+  // Accelerate steady runs by FAS multigrid on (at most) `n_levels` levels of
+  // agglomerated cells, in which each step runs one cycle.  Each level is
+  // smoothed by `n_smoothings` local time steps (of the CFL number given to
+  // UseLocalTimeSteps()) before and after visiting the coarser level `gamma`
+  // times, i.e. 1 for V-cycles and 2 for W-cycles.  The sizes of levels and
+  // the convergence factor of each cycle are printed.  It excludes implicit
+  // steps, LU-SGS, sparse matrices, ensembles and subdomains.
+  void UseMultigrid(int n_levels, int gamma = 1, int n_smoothings = 1) {
+    multigrid_ = Agglomeration<Mesh, Riemann>(n_levels, gamma, n_smoothings);
+  }
+  // Accessors:
+  Mesh const& GetMesh() const { return *mesh_; }
+  // Accessors (ensemble only):
+  State const& GetState(Cell const& cell, int member) const {
+    return ensemble_.GetState(cell_to_index_.at(&cell), member);
+  }
+  // Major computation, which throws `std::invalid_argument` if the modes
+  // chosen above conflict:
   void Calculate() {
+    CheckModes();
     wall_manager_.ClearBoundaryCondition();
+    if constexpr (Riemann::IsLinear()) {
+      if (use_sparse_matrix_) { AssembleSparseMatrix(); }
+    }
+    if (UseEnsemble()) {
+      ensemble_.Link(&wall_manager_, cell_to_index_);
+    } else if (UseSubdomains()) {
+      Decompose();
+    } else {
+      LinkWallsToStates();
+    }
     writer_ = Writer();
     // Write the frame of initial state:
     auto filename = dir_ + model_name_ + "." + std::to_string(0) + ".vtu";
     bool pass = WriteCurrentFrame(filename);
     assert(pass);
+    if (rollback_.IsEnabled()) {
+      rollback_.Save(0, [&](std::vector<State>* states) {
+        SaveStates(states);
+      });
+    }
+    if (steady_.IsEnabled()) {
+      steady_.Start(dir_ + model_name_ + ".residual");
+    }
     // Write other steps:
     for (int i = 1; i <= n_steps_ && pass; i++) {
-      UpdateEachWall();
-      UpdateEachCell();
-      if (i % refresh_rate_ == 0) {
+      if (UseSubdomains()) {
+        // Run in parallel until the next frame:
+        int last = (i + refresh_rate_ - 1) / refresh_rate_ * refresh_rate_;
+        last = std::min(last, n_steps_);
+        AdvanceSubdomains(i - 1, last);
+        for (; i < last; ++i) { std::printf("Progress: %d/%d\n", i, n_steps_); }
+      } else {
+        // Halved steps are made up by more substeps:
+        for (int k = 1 << rollback_.CountHalvings(); k; --k) {
+          UpdateEachStep();
+        }
+      }
+      // Check before writing, so no garbage frame is written:
+      if (watchdog_.IsDue(i) || (watchdog_.IsEnabled() && UseSubdomains())) {
+        auto bad_states = FindBadStates();
+        if (!rollback_.IsEnabled()) {
+          if (bad_states.size()) { throw Blowup(i, Report(i, bad_states)); }
+        } else if (bad_states.size()) {
+          i = RollBack(i, bad_states);
+          continue;
+        } else if (rollback_.Save(i, [&](std::vector<State>* states) {
+                     SaveStates(states);
+                   })) {
+          UpdateStepSize();
+        }
+      }
+      bool is_steady = steady_.IsEnabled() && steady_.IsSteady(i);
+      if (i % refresh_rate_ == 0 || is_steady) {
         filename = dir_ + model_name_ + "." +std::to_string(i) + ".vtu";
         pass = WriteCurrentFrame(filename);
       }
       std::printf("Progress: %d/%d\n", i, n_steps_);
+      if (is_steady) { break; }
+    }
+    if constexpr (Riemann::IsLinear()) {
+      if (use_sparse_matrix_) { linear_.Scatter(); }
     }
   }
 
  private:
+  // Throw if some modes chosen by Use*() and Set*() cannot work together, in
+  // which case one of them would be silently ignored:
+  void CheckModes() const {
+    auto reject = [](bool conflict, std::string const& message) {
+      if (conflict) { throw std::invalid_argument(message); }
+    };
+    bool use_sparse_matrix = false;
+    if constexpr (Riemann::IsLinear()) {
+      use_sparse_matrix = use_sparse_matrix_;
+    }
+    bool use_subdomains = n_subdomains_ > 1;
+    reject(use_sparse_matrix && use_subdomains,
+           "`UseSparseMatrix()` excludes `UseSubdomains()`.");
+    reject(UseEnsemble() && (use_sparse_matrix || use_subdomains),
+           "`UseEnsemble()` excludes sparse matrices and subdomains.");
+    reject(rollback_.IsEnabled() && !watchdog_.IsEnabled(),
+           "`SetRollback()` needs `SetWatchdog()`.");
+    reject(rollback_.IsEnabled() && use_subdomains,
+           "`SetRollback()` excludes `UseSubdomains()`.");
+    reject(steady_.IsEnabled() && (UseEnsemble() || use_subdomains),
+           "`SetSteadyState()` excludes ensembles and subdomains.");
+    reject(UseLocalTimeSteps() && !steady_.IsEnabled(),
+           "`UseLocalTimeSteps()` needs `SetSteadyState()`.");
+    reject(UseLocalTimeSteps() && use_sparse_matrix,
+           "`UseLocalTimeSteps()` excludes `UseSparseMatrix()`.");
+    reject(UseImplicitSteps() && UseLuSgsSteps(),
+           "`UseImplicitSteps()` excludes `UseLuSgsSteps()`.");
+    reject((UseImplicitSteps() || UseLuSgsSteps()) &&
+           (use_sparse_matrix || UseEnsemble() || use_subdomains),
+           "Implicit steps and LU-SGS exclude sparse matrices, ensembles"
+           " and subdomains.");
+    reject(UseMultigrid() && !UseLocalTimeSteps(),
+           "`UseMultigrid()` needs `UseLocalTimeSteps()`.");
+    reject(UseMultigrid() && (UseImplicitSteps() || UseLuSgsSteps()),
+           "`UseMultigrid()` excludes implicit steps and LU-SGS.");
+  }
   bool WriteCurrentFrame(std::string const& filename) {
+    if constexpr (Riemann::IsLinear()) {
+      if (use_sparse_matrix_) { linear_.Scatter(); }
+    }
+    if (UseEnsemble()) { ensemble_.ScatterMeans(); }
     mesh_->ForEachCell([&](Cell& cell) {
       cell.data.Write();
     });
     writer_.SetMesh(mesh_.get());
     return writer_.WriteToFile(filename);
   }
-  void Preprocess() {
+  bool LoadMesh(std::string const& file_name,
+                std::unordered_map<Wall const*, int>* wall_to_tag,
+                std::map<int, std::string>* tag_to_name) {
+    if (cache_dir_.empty()) {
+      return ParseMesh(file_name, wall_to_tag, tag_to_name);
+    }
+    auto key = MeshCache::Hash(file_name);
+    auto cache_name = cache_dir_ + MeshCache::GetFileName(key);
+    auto cache = MeshCache();
+    if (cache.ReadFromFile(cache_name, key)) {
+      mesh_ = cache.GetMesh();
+      *wall_to_tag = cache.GetWallTags();
+      *tag_to_name = cache.GetBoundaryNames();
+      return true;
+    }
+    if (!ParseMesh(file_name, wall_to_tag, tag_to_name)) { return false; }
+    // A cache failing to be written only costs the next run a parsing:
+    MeshCache::WriteToFile(cache_name, key, *mesh_, *wall_to_tag,
+                           *tag_to_name);
+    return true;
+  }
+  // Boundary walls in physical groups of a .msh file are tagged by them:
+  bool ParseMesh(std::string const& file_name,
+                 std::unordered_map<Wall const*, int>* wall_to_tag,
+                 std::map<int, std::string>* tag_to_name) {
+    auto suffix = std::string(".msh");
+    if (file_name.size() >= suffix.size() &&
+        file_name.compare(file_name.size() - suffix.size(), suffix.size(),
+                          suffix) == 0) {
+      auto reader = mesh::GmshReader<Mesh>();
+      if (!reader.ReadFromFile(file_name)) { return false; }
+      *wall_to_tag = reader.GetWallTags();
+      for (auto& pair : reader.GetPhysicalNames()) {
+        auto dim = pair.first.first, tag = pair.first.second;
+        if (dim == 1) { tag_to_name->emplace(tag, pair.second); }
+      }
+      mesh_ = reader.GetMesh();
+      return true;
+    }
+    reader_ = Reader();
+    if (!reader_.ReadFromFile(file_name)) { return false; }
+    mesh_ = reader_.GetMesh();
+    return true;
+  }
+  void Preprocess(std::unordered_map<Wall const*, int> const& wall_to_tag) {
     mesh_->ForEachWall([&](Wall& wall){
       auto length = wall.Measure();
       auto n1 = (wall.Tail()->Y() - wall.Head()->Y()) / length;
@@ -106,84 +444,274 @@ class Godunov {
       auto right_cell = wall.GetNegativeSide();
       if (left_cell && right_cell) {
         wall_manager_.AddInteriorWall(&wall);
+      } else if (wall_to_tag.count(&wall)) {
+        wall_manager_.AddBoundaryWall(&wall, wall_to_tag.at(&wall));
       } else {
         wall_manager_.AddBoundaryWall(&wall);
       }
     });
   }
-  void UpdateEachWall() {
-    wall_manager_.ForEachInteriorWall([](Wall* wall){
-      auto& riemann_ = wall->data.riemann;
-      auto const& u_l = wall->GetPositiveSide()->data.state;
-      auto const& u_r = wall->GetNegativeSide()->data.state;
-      wall->data.flux = riemann_.GetFluxOnTimeAxis(u_l, u_r);
-      wall->data.flux *= wall->Measure();
+  bool UseSubdomains() const {
+    bool use_sparse_matrix = false;
+    if constexpr (Riemann::IsLinear()) {
+      use_sparse_matrix = use_sparse_matrix_;
+    }
+    return n_subdomains_ > 1 && !use_sparse_matrix;
+  }
+  void Decompose() {
+    auto partition = mesh::Partition<Mesh>(mesh_.get(), n_subdomains_);
+    subdomains_ = std::vector<Domain>(n_subdomains_);
+    auto owner_of = [&](Cell const* cell) {
+      return &subdomains_[partition.GetPart(*cell)];
+    };
+    for (int p = 0; p != n_subdomains_; ++p) {
+      for (auto cell : partition.GetCells(p)) {
+        subdomains_[p].AddCell(cell);
+      }
+    }
+    // A wall goes to the subdomain(s) owning its neighbors:
+    using Kind = typename Domain::Kind;
+    auto add = [&](Wall* wall, Kind kind) {
+      for (auto cell : {wall->GetPositiveSide(), wall->GetNegativeSide()}) {
+        if (cell) { owner_of(cell)->AddWall(wall, kind, owner_of); }
+      }
+    };
+    wall_manager_.ForEachInteriorWall([&](Wall* wall) {
+      add(wall, Kind::kTwoSided);
     });
-    wall_manager_.ForEachPeriodicWall([](Wall* wall){
-      auto& riemann_ = wall->data.riemann;
-      auto const& u_l = wall->GetPositiveSide()->data.state;
-      auto const& u_r = wall->GetNegativeSide()->data.state;
-      wall->data.flux = riemann_.GetFluxOnTimeAxis(u_l, u_r);
-      wall->data.flux *= wall->Measure();
+    wall_manager_.ForEachFreeWall([&](Wall* wall) {
+      add(wall, Kind::kFree);
     });
-    wall_manager_.ForEachFreeWall([](Wall* wall){
-      auto& riemann_ = wall->data.riemann;
-      auto left_cell = wall->GetPositiveSide();
-      auto right_cell = wall->GetNegativeSide();
-      if (left_cell) {
-        auto const& u = wall->GetPositiveSide()->data.state;
-        wall->data.flux = riemann_.GetFluxOnFreeWall(u);
-      } else {
-        auto const& u = wall->GetNegativeSide()->data.state;
-        wall->data.flux = riemann_.GetFluxOnFreeWall(u);
-      }
-      wall->data.flux *= wall->Measure();
+    wall_manager_.ForEachSolidWall([&](Wall* wall) {
+      add(wall, Kind::kSolid);
     });
-    wall_manager_.ForEachSolidWall([](Wall* wall){
-      auto& riemann_ = wall->data.riemann;
-      auto left_cell = wall->GetPositiveSide();
-      auto right_cell = wall->GetNegativeSide();
-      if (left_cell) {
-        auto const& u = wall->GetPositiveSide()->data.state;
-        wall->data.flux = riemann_.GetFluxOnSolidWall(u);
-      } else {
-        auto const& u = wall->GetNegativeSide()->data.state;
-        wall->data.flux = riemann_.GetFluxOnSolidWall(u);
+    for (auto& subdomain : subdomains_) {
+      subdomain.Compress();
+      subdomain.ForEachSender([&](Domain const* sender) {
+        auto& outbox_owner = subdomains_[sender - subdomains_.data()];
+        outbox_owner.AddOutbox(&subdomain, subdomain.GetGhosts(sender));
+      });
+    }
+  }
+  // Advance each subdomain from step `first` to step `last`:
+  void AdvanceSubdomains(int first, int last) {
+    auto threads = std::vector<std::thread>();
+    for (auto& subdomain : subdomains_) {
+      threads.emplace_back([&subdomain, first, last, this]() {
+        subdomain.Gather();
+        for (int step = first; step != last; ++step) {
+          subdomain.Advance(step, step_size_);
+        }
+        subdomain.Scatter();
+      });
+    }
+    for (auto& thread : threads) { thread.join(); }
+  }
+  void UpdateEachStep() {
+    auto steady = steady_.IsEnabled() ? &steady_ : nullptr;
+    if (steady) { steady->Clear(); }
+    if (UseEnsemble()) {
+      ensemble_.Advance(step_size_);
+      return;
+    }
+    if constexpr (Riemann::IsLinear()) {
+      if (use_sparse_matrix_) {
+        linear_.Advance(step_size_, steady);
+        return;
       }
-      wall->data.flux *= wall->Measure();;
+    }
+    auto get_step_size = [&](int i_cell) {
+      return UseLocalTimeSteps() ? GetLocalStepSize(i_cell) : step_size_;
+    };
+    if (UseImplicitSteps()) {
+      implicit_.Advance(&sweep_, cells_, measures_, get_step_size, steady);
+      return;
+    }
+    if (UseLuSgsSteps()) {
+      lu_sgs_.Advance(&sweep_, cells_, measures_, get_step_size, steady);
+      return;
+    }
+    if (UseMultigrid()) {
+      // The CFL number is halved by rollbacks:
+      auto cfl = local_cfl_ / (1 << rollback_.CountHalvings());
+      multigrid_.Advance(cells_, cfl, steady);
+      return;
+    }
+    sweep_.UpdateFluxes();
+    if (UseLocalTimeSteps()) { sweep_.SumWaveSpeeds(); }
+    UpdateEachCell();
+  }
+  // Link every wall to the states on its two sides, in which boundary walls
+  // get ghost states, so that all walls share one flux kernel:
+  void LinkWallsToStates() {
+    sweep_.Link(&wall_manager_);
+    if (UseLocalTimeSteps() || UseImplicitSteps() || UseLuSgsSteps()) {
+      LinkWallsToCells();
+    }
+  }
+  // Index cells in the order of ForEachCell():
+  void IndexCells() {
+    cells_.clear();
+    cell_to_index_.clear();
+    mesh_->ForEachCell([&](Cell& cell) {
+      cell_to_index_.emplace(&cell, cells_.size());
+      cells_.emplace_back(&cell);
     });
   }
   void UpdateEachCell() {
-    mesh_->ForEachCell([&](Cell& cell) {
-      auto net_flux = Flux{};
-      cell.ForEachWall([&](Wall& wall) {
-        if (wall.GetPositiveSide() == &cell) {
-          net_flux -= wall.data.flux;
-        } else {
-          net_flux += wall.data.flux;
-        }
-      });
-      net_flux /= cell.Measure();
-      TimeStepping(&(cell.data.state), &net_flux);
+    int i_cell = 0;
+    mesh_->ForEachCell([&](auto& cell) {
+      auto net_flux = Sweep<Mesh, Riemann>::GetNetFlux(cell);
+      if (steady_.IsEnabled()) { steady_.Add(net_flux); }
+      auto step_size = step_size_;
+      if (UseLocalTimeSteps()) { step_size = GetLocalStepSize(i_cell++); }
+      TimeStepping(&(cell.data.state), &net_flux, step_size);
     });
   }
-  void TimeStepping(State* u_curr , Flux* du_dt) {
-    *du_dt *= step_size_;
+  void TimeStepping(State* u_curr , Flux* du_dt, double step_size) {
+    *du_dt *= step_size;
     *u_curr += *du_dt;
   }
+  // Local time stepping only:
+  bool UseLocalTimeSteps() const { return local_cfl_ > 0; }
+  // Cell sizes are fixed, and so are the cells beside each wall:
+  void LinkWallsToCells() {
+    IndexCells();
+    measures_.clear();
+    for (auto cell : cells_) { measures_.emplace_back(cell->Measure()); }
+    sweep_.LinkToCells(cell_to_index_);
+    if (UseImplicitSteps()) {
+      implicit_.Link(sweep_, cells_.size(), use_ilu_);
+    }
+    if (UseLuSgsSteps()) { lu_sgs_.Link(sweep_, cells_); }
+    if (UseMultigrid()) { multigrid_.Build(sweep_, measures_); }
+  }
+  // Halved by rollbacks as the global one:
+  double GetLocalStepSize(int i_cell) const {
+    auto wave_sum = sweep_.GetWaveSum(i_cell);
+    if (wave_sum == 0) { return step_size_; }  // nothing moves
+    auto cfl = local_cfl_ / (1 << rollback_.CountHalvings());
+    return cfl * measures_[i_cell] / wave_sum;
+  }
+  bool UseLuSgsSteps() const { return lu_sgs_.IsEnabled(); }
+  bool UseImplicitSteps() const { return implicit_.IsEnabled(); }
+  bool UseMultigrid() const { return multigrid_.IsEnabled(); }
+  // Find the (cell, member) of each unhealthy state:
+  std::vector<Bad> FindBadStates() {
+    auto bad_states = std::vector<Bad>();
+    if (UseEnsemble()) {
+      auto& members = ensemble_.GetStates();
+      if (Watchdog<Riemann>::AreHealthy(members.data(), members.size())) {
+        return bad_states;
+      }
+      int n_members = ensemble_.CountMembers();
+      int n_states = members.size();
+      for (int i = 0; i != n_states; ++i) {
+        if (!Watchdog<Riemann>::IsHealthy(members[i])) {
+          bad_states.emplace_back(cells_[i / n_members], i % n_members);
+        }
+      }
+      return bad_states;
+    }
+    if constexpr (Riemann::IsLinear()) {
+      if (use_sparse_matrix_) { linear_.Scatter(); }
+    }
+    mesh_->ForEachCell([&](Cell const& cell) {
+      if (!Watchdog<Riemann>::IsHealthy(cell.data.state)) {
+        bad_states.emplace_back(&cell, 0);
+      }
+    });
+    return bad_states;
+  }
+  std::string Report(int step, std::vector<Bad> const& bad_states) const {
+    auto state_of = [&](Cell const& cell, int member) -> State const& {
+      return UseEnsemble() ? GetState(cell, member) : cell.data.state;
+    };
+    return watchdog_.Report(step, bad_states, state_of, UseEnsemble());
+  }
+  // Restart from a healthy snapshot with a halved step size, and return the
+  // step of that snapshot:
+  int RollBack(int step, std::vector<Bad> const& bad_states) {
+    auto snapshot = rollback_.Fail();
+    if (snapshot == nullptr) { throw Blowup(step, Report(step, bad_states)); }
+    LoadStates(snapshot->states);
+    UpdateStepSize();
+    std::printf("Roll back from step %d to %d, with step size %g\n",
+                step, snapshot->step, step_size_);
+    return snapshot->step;
+  }
+  void UpdateStepSize() {
+    step_size_ = duration_ / n_steps_;
+    step_size_ /= (1 << rollback_.CountHalvings());
+    if constexpr (Riemann::IsLinear()) {
+      // The step size is built into the matrix:
+      if (use_sparse_matrix_) { AssembleSparseMatrix(); }
+    }
+  }
+  // Copy all states (in the order of cells) to or from a snapshot:
+  void SaveStates(std::vector<State>* states) {
+    if (UseEnsemble()) {
+      *states = ensemble_.GetStates();
+      return;
+    }
+    if constexpr (Riemann::IsLinear()) {
+      if (use_sparse_matrix_) { linear_.Scatter(); }
+    }
+    states->clear();
+    mesh_->ForEachCell([&](Cell const& cell) {
+      states->emplace_back(cell.data.state);
+    });
+  }
+  void LoadStates(std::vector<State> const& states) {
+    if (UseEnsemble()) {
+      ensemble_.SetStates(states);
+      return;
+    }
+    int i = 0;
+    mesh_->ForEachCell([&](Cell& cell) { cell.data.state = states[i++]; });
+    if constexpr (Riemann::IsLinear()) {
+      if (use_sparse_matrix_) { linear_.Gather(); }
+    }
+  }
+  bool UseEnsemble() const { return ensemble_.IsEnabled(); }
+  // Linear models only:
+  void AssembleSparseMatrix() {
+    IndexCells();
+    linear_.Assemble(&wall_manager_, cells_, cell_to_index_, step_size_);
+  }
 
  private:
   std::string model_name_;
   Reader reader_;
   Writer writer_;
   std::unique_ptr<Mesh> mesh_;
+  std::string cache_dir_;
   double duration_;
   int n_steps_;
   double step_size_;
   std::string dir_;
   int refresh_rate_;
-  std::set<Wall*> inside_wall_;
   Manager<Mesh> wall_manager_;
+  Sweep<Mesh, Riemann> sweep_;
+  std::vector<Cell*> cells_;  // in the order of ForEachCell()
+  std::unordered_map<Cell const*, int> cell_to_index_;
+  std::vector<double> measures_;  // of cells_
+  // Linear models only:
+  bool use_sparse_matrix_{false};
+  Linear<Mesh, Riemann> linear_;
+  // Domain decomposition only:
+  int n_subdomains_{1};
+  std::vector<Domain> subdomains_;
+  Watchdog<Riemann> watchdog_;
+  Rollback<State> rollback_;
+  Steady<kComponents> steady_;
+  // Local time stepping only:
+  double local_cfl_{0.0};
+  LuSgs<Mesh, Riemann> lu_sgs_;
+  Implicit<Mesh, Riemann> implicit_;
+  bool use_ilu_{false};
+  Agglomeration<Mesh, Riemann> multigrid_;
+  Ensemble<Mesh, Riemann> ensemble_;
 };
 
 }  // namespace model
@@ -0,0 +1,284 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_IMPLICIT_HPP_
+#define MINI_MODEL_IMPLICIT_HPP_
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "mini/algebra/gmres.hpp"
+#include "mini/algebra/lu.hpp"
+#include "mini/algebra/sparse.hpp"
+#include "mini/model/steady.hpp"
+#include "mini/model/sweep.hpp"
+
+namespace mini {
+namespace model {
+
+// Backward Euler steps, i.e. (u' - u) / dt = R(u') solved for the new states
+// u' by Newton's method.  Each linear system is solved by GMRES, in which
+// products with the Jacobian of R are finite differences of R itself, and
+// the preconditioner is the inverse diagonal blocks (or the block ILU(0)) of
+// (I / dt - dR/du) built from per-wall flux Jacobians.
+template <class Mesh, class Riemann>
+class Implicit {
+  using Cell = typename Mesh::Cell;
+  using State = typename Riemann::State;
+  using Flux = typename Riemann::Flux;
+  using Sweep = model::Sweep<Mesh, Riemann>;
+  static constexpr int kComponents = sizeof(State) / sizeof(double);
+  using Sparse = algebra::Sparse<double, kComponents>;
+  using Block = typename Sparse::Block;
+  using Column = typename Sparse::Column;
+  using Gmres = algebra::Gmres<double>;
+  using Vector = typename Gmres::Vector;  // all states, flattened
+  using Lu = algebra::Lu<double, kComponents>;
+  using WallBlocks = std::array<int, 4>;  // (p, p), (p, n), (n, p), (n, n)
+
+ public:
+  // Constructors:
+  Implicit() = default;
+  Implicit(int n_newtons, double tolerance, int n_krylov)
+      : gmres_(n_krylov, n_krylov, tolerance), n_newtons_(n_newtons) {
+    assert(n_newtons > 0);
+  }
+  // Accessors:
+  bool IsEnabled() const { return n_newtons_ > 0; }
+  // Mutators:
+  // Store the diagonal blocks of (I / dt - dR/du), and also the blocks
+  // linking the two sides of each wall if `use_ilu`:
+  void Link(Sweep const& sweep, int n_cells, bool use_ilu) {
+    use_ilu_ = use_ilu;
+    preconditioner_ = Sparse(n_cells);
+    for (int i = 0; i != n_cells; ++i) {
+      preconditioner_.Emplace(i, i, Block{});
+    }
+    int n_walls = sweep.CountWalls();
+    for (int i = 0; i != n_walls; ++i) {
+      auto positive = sweep.GetCells(i).first;
+      auto negative = sweep.GetCells(i).second;
+      if (use_ilu_ && positive >= 0 && negative >= 0) {
+        preconditioner_.Emplace(positive, negative, Block{});
+        preconditioner_.Emplace(negative, positive, Block{});
+      }
+    }
+    preconditioner_.Compress();
+    wall_blocks_.clear();
+    for (int i = 0; i != n_walls; ++i) {
+      auto positive = sweep.GetCells(i).first;
+      auto negative = sweep.GetCells(i).second;
+      auto find = [&](int row, int column) {
+        return row < 0 || column < 0 ? -1 : preconditioner_.Find(row, column);
+      };
+      wall_blocks_.push_back({find(positive, positive),
+                              find(positive, negative),
+                              find(negative, positive),
+                              find(negative, negative)});
+    }
+  }
+  // Solve F(u) = (u - u_n) / dt - R(u) = 0 on `cells` (whose areas are
+  // `measures`), in which the k-th Newton step solves
+  // (I / dt - dR/du) * du = -F(u_k).  Wave speeds are summed on u_n, before
+  // `get_step_size(i)` gives the dt of the i-th cell, and R(u_n) is given to
+  // `steady` (if not nullptr):
+  template <class StepSize>
+  void Advance(Sweep* sweep, std::vector<Cell*> const& cells,
+               std::vector<double> const& measures, StepSize&& get_step_size,
+               Steady<kComponents>* steady) {
+    sweep_ = sweep;
+    cells_ = &cells;
+    int n_cells = cells.size();
+    auto n = n_cells * kComponents;
+    u_n_.resize(n);
+    for (int i = 0; i != n_cells; ++i) {
+      AsStates(&u_n_)[i] = cells[i]->data.state;
+    }
+    u_ = u_n_;
+    rates_.resize(n);
+    GetRates(u_, &rates_);
+    if (steady) {
+      auto rates = reinterpret_cast<Flux const*>(rates_.data());
+      for (int i = 0; i != n_cells; ++i) { steady->Add(rates[i]); }
+    }
+    sweep->SumWaveSpeeds();
+    step_sizes_.resize(n_cells);
+    for (int i = 0; i != n_cells; ++i) { step_sizes_[i] = get_step_size(i); }
+    AssemblePreconditioner(measures);  // on the states of u_n
+    auto product = [&](Vector const& v, Vector* y) { MultiplyJacobian(v, y); };
+    auto precondition = [&](Vector const& v, Vector* y) {
+      static_assert(sizeof(Column) == sizeof(State));
+      auto columns = reinterpret_cast<Column const*>(v.data());
+      auto products = reinterpret_cast<Column*>(y->data());
+      if (use_ilu_) {
+        preconditioner_.Solve(columns, products);
+        return;
+      }
+      for (int i = 0; i != n_cells; ++i) {
+        products[i] = inverse_diagonals_[i] * columns[i];
+      }
+    };
+    minus_f_.resize(n);
+    du_.resize(n);
+    for (int k = 0; k != n_newtons_; ++k) {
+      if (k) { GetRates(u_, &rates_); }
+      for (int j = 0; j != n; ++j) {
+        auto dt = step_sizes_[j / kComponents];
+        minus_f_[j] = rates_[j] - (u_[j] - u_n_[j]) / dt;
+      }
+      du_.assign(n, 0.0);
+      gmres_.Solve(product, precondition, minus_f_, &du_);
+      for (int j = 0; j != n; ++j) { u_[j] += du_[j]; }
+    }
+    for (int i = 0; i != n_cells; ++i) {
+      cells[i]->data.state = AsStates(u_)[i];
+    }
+  }
+
+ private:
+  static State* AsStates(Vector* v) {
+    return reinterpret_cast<State*>(v->data());
+  }
+  static State const* AsStates(Vector const& v) {
+    return reinterpret_cast<State const*>(v.data());
+  }
+  // r = R(u), i.e. d(state)/dt of all cells (in the order of cells_):
+  void GetRates(Vector const& u, Vector* r) {
+    static_assert(sizeof(Flux) == sizeof(State));
+    auto& cells = *cells_;
+    int n_cells = cells.size();
+    auto states = AsStates(u);
+    for (int i = 0; i != n_cells; ++i) {
+      cells[i]->data.state = states[i];
+    }
+    sweep_->UpdateFluxes();
+    auto rates = reinterpret_cast<Flux*>(r->data());
+    for (int i = 0; i != n_cells; ++i) {
+      rates[i] = Sweep::GetNetFlux(*cells[i]);
+    }
+  }
+  // y = (I / dt - dR/du) * v, where dR/du * v is approximated by
+  // (R(u + eps * v) - R(u)) / eps at u = u_, whose rates_ are up to date:
+  void MultiplyJacobian(Vector const& v, Vector* y) {
+    int n = v.size();
+    auto v_norm = std::sqrt(std::inner_product(v.begin(), v.end(),
+                                               v.begin(), 0.0));
+    if (v_norm == 0) {
+      y->assign(n, 0.0);
+      return;
+    }
+    auto u_norm = std::sqrt(std::inner_product(u_.begin(), u_.end(),
+                                               u_.begin(), 0.0));
+    auto eps = std::sqrt(std::numeric_limits<double>::epsilon() *
+                         (1 + u_norm)) / v_norm;
+    perturbed_.resize(n);
+    for (int j = 0; j != n; ++j) { perturbed_[j] = u_[j] + eps * v[j]; }
+    perturbed_rates_.resize(n);
+    GetRates(perturbed_, &perturbed_rates_);
+    for (int j = 0; j != n; ++j) {
+      auto dt = step_sizes_[j / kComponents];
+      auto jv = (perturbed_rates_[j] - rates_[j]) / eps;
+      (*y)[j] = v[j] / dt - jv;
+    }
+  }
+  // Assemble and factor (I / dt - dR/du), in which the flux on each wall is
+  // differentiated by perturbing the state of each neighbor (and the ghost
+  // state with it).  It is exact for linear solvers.
+  void AssemblePreconditioner(std::vector<double> const& measures) {
+    preconditioner_.SetZero();
+    int n_walls = sweep_->CountWalls();
+    for (int i = 0; i != n_walls; ++i) {
+      auto wall = sweep_->GetWall(i);
+      auto& riemann = wall->data.riemann;
+      auto length = wall->Measure();
+      auto u_l = *sweep_->GetSides(i).first;
+      auto u_r = *sweep_->GetSides(i).second;
+      auto positive = sweep_->GetCells(i).first;
+      auto negative = sweep_->GetCells(i).second;
+      auto ghost = sweep_->GetGhost(i);
+      auto flux = ghost ? Sweep::GetFluxOnBoundary(&riemann, *ghost->inner,
+                                                   ghost->is_solid,
+                                                   positive >= 0)
+                        : riemann.GetFluxOnTimeAxis(u_l, u_r);
+      // d(flux)/du, by perturbing each component of `*u` in place:
+      auto differentiate = [&](State* u, auto&& get_flux) {
+        auto values = reinterpret_cast<double*>(u);
+        auto f = reinterpret_cast<double const*>(&flux);
+        auto jacobian = Block{};
+        for (int k = 0; k != kComponents; ++k) {
+          auto value = values[k];
+          auto h = std::sqrt(std::numeric_limits<double>::epsilon()) *
+                   (1 + std::abs(value));
+          values[k] += h;
+          auto perturbed_flux = get_flux();
+          values[k] = value;
+          auto df = reinterpret_cast<double const*>(&perturbed_flux);
+          for (int r = 0; r != kComponents; ++r) {
+            jacobian[r][k] = (df[r] - f[r]) / h;
+          }
+        }
+        return jacobian;
+      };
+      // R of the positive side is -flux * length / measure, so its row gets
+      // +jacobian * length / measure, and the negative side's row the minus:
+      auto add = [&](int block, int row, double sign, Block const& jacobian) {
+        if (block < 0) { return; }
+        auto& a = preconditioner_.GetBlock(block);
+        auto scale = sign * length / measures[row];
+        for (int r = 0; r != kComponents; ++r) { a[r] += jacobian[r] * scale; }
+      };
+      auto& blocks = wall_blocks_[i];
+      auto pp = blocks[0], pn = blocks[1], np = blocks[2], nn = blocks[3];
+      if (ghost == nullptr) {
+        auto get_flux = [&]() { return riemann.GetFluxOnTimeAxis(u_l, u_r); };
+        auto jacobian = differentiate(&u_l, get_flux);
+        add(pp, positive, +1.0, jacobian);
+        add(np, negative, -1.0, jacobian);
+        jacobian = differentiate(&u_r, get_flux);
+        add(pn, positive, +1.0, jacobian);
+        add(nn, negative, -1.0, jacobian);
+        continue;
+      }
+      auto inner = *ghost->inner;
+      bool inner_is_positive = positive >= 0;
+      auto jacobian = differentiate(&inner, [&]() {
+        return Sweep::GetFluxOnBoundary(&riemann, inner, ghost->is_solid,
+                                        inner_is_positive);
+      });
+      if (inner_is_positive) {
+        add(pp, positive, +1.0, jacobian);
+      } else {
+        add(nn, negative, -1.0, jacobian);
+      }
+    }
+    int n_cells = step_sizes_.size();
+    inverse_diagonals_.resize(n_cells);
+    for (int i = 0; i != n_cells; ++i) {
+      auto& diagonal = preconditioner_.GetBlock(preconditioner_.Find(i, i));
+      for (int k = 0; k != kComponents; ++k) {
+        diagonal[k][k] += 1 / step_sizes_[i];
+      }
+      if (!use_ilu_) { inverse_diagonals_[i] = Lu(diagonal).Inverse(); }
+    }
+    if (use_ilu_) { preconditioner_.FactorIlu(); }
+  }
+
+  Gmres gmres_;
+  int n_newtons_{0};
+  bool use_ilu_{false};
+  Sparse preconditioner_;
+  std::vector<WallBlocks> wall_blocks_;
+  std::vector<Block> inverse_diagonals_;  // block-Jacobi only
+  std::vector<double> step_sizes_;
+  Vector u_n_, u_, rates_, minus_f_, du_, perturbed_, perturbed_rates_;
+  // Borrowed in Advance() only:
+  Sweep* sweep_{nullptr};
+  std::vector<Cell*> const* cells_{nullptr};
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_IMPLICIT_HPP_
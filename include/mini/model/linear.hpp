@@ -0,0 +1,177 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_LINEAR_HPP_
+#define MINI_MODEL_LINEAR_HPP_
+
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mini/algebra/sparse.hpp"
+#include "mini/model/boundary.hpp"
+#include "mini/model/steady.hpp"
+
+namespace mini {
+namespace model {
+
+// Explicit steps of a linear model by a sparse matrix, i.e.
+// u_next = (I + step_size * M) * u_curr, in which M is probed from the
+// Riemann solver on each wall once, and the step size is built in.
+template <class Mesh, class Riemann>
+class Linear {
+  using Wall = typename Mesh::Wall;
+  using Cell = typename Mesh::Cell;
+  using State = typename Riemann::State;
+  static constexpr int kComponents = sizeof(State) / sizeof(double);
+  using Sparse = algebra::Sparse<double, kComponents>;
+  using Block = typename Sparse::Block;
+  using Column = typename Sparse::Column;
+
+ public:
+  // Constructors:
+  Linear() = default;
+  explicit Linear(int n_threads) : n_threads_(n_threads) {}
+  // Mutators:
+  // Assemble the matrix on `cells` (indexed by `cell_to_index`), and gather
+  // their states:
+  void Assemble(Manager<Mesh>* manager, std::vector<Cell*> const& cells,
+                std::unordered_map<Cell const*, int> const& cell_to_index,
+                double step_size) {
+    cells_ = cells;
+    // Probe each wall for the linear map from neighbor states to its flux:
+    auto wall_to_operator = std::unordered_map<Wall const*, WallOperator>();
+    auto zero = State{};
+    auto add_two_sided = [&](Wall* wall) {
+      auto& riemann = wall->data.riemann;
+      auto& op = wall_to_operator[wall];
+      op.positive_side = cell_to_index.at(wall->GetPositiveSide());
+      op.negative_side = cell_to_index.at(wall->GetNegativeSide());
+      op.positive_block = GetBlock([&](State const& u) {
+        return riemann.GetFluxOnTimeAxis(u, zero);
+      }) * wall->Measure();
+      op.negative_block = GetBlock([&](State const& u) {
+        return riemann.GetFluxOnTimeAxis(zero, u);
+      }) * wall->Measure();
+    };
+    auto add_one_sided = [&](Wall* wall, auto&& flux_of_state) {
+      auto& op = wall_to_operator[wall];
+      auto block = GetBlock(flux_of_state) * wall->Measure();
+      if (wall->GetPositiveSide()) {
+        op.positive_side = cell_to_index.at(wall->GetPositiveSide());
+        op.positive_block = block;
+      } else {
+        op.negative_side = cell_to_index.at(wall->GetNegativeSide());
+        op.negative_block = block;
+      }
+    };
+    manager->ForEachInteriorWall(add_two_sided);
+    manager->ForEachFreeWall([&](Wall* wall) {
+      auto& riemann = wall->data.riemann;
+      add_one_sided(wall, [&](State const& u) {
+        return riemann.GetFluxOnFreeWall(u);
+      });
+    });
+    manager->ForEachSolidWall([&](Wall* wall) {
+      auto& riemann = wall->data.riemann;
+      add_one_sided(wall, [&](State const& u) {
+        return riemann.GetFluxOnSolidWall(u);
+      });
+    });
+    // u_next = (I + step_size * M) * u_curr
+    int n_cells = cells_.size();
+    matrix_ = Sparse(n_cells);
+    auto identity = Block();
+    for (int i = 0; i != kComponents; ++i) { identity[i][i] = 1.0; }
+    for (int i = 0; i != n_cells; ++i) {
+      auto& cell = *cells_[i];
+      matrix_.Emplace(i, i, identity);
+      cell.ForEachWall([&](Wall& wall) {
+        auto& op = wall_to_operator.at(&wall);
+        auto scale = step_size / cell.Measure();
+        if (wall.GetPositiveSide() == &cell) { scale = -scale; }
+        if (op.positive_side >= 0) {
+          matrix_.Emplace(i, op.positive_side, op.positive_block * scale);
+        }
+        if (op.negative_side >= 0) {
+          matrix_.Emplace(i, op.negative_side, op.negative_block * scale);
+        }
+      });
+    }
+    matrix_.Compress();
+    Gather();
+  }
+  // Copy states between the cells and the columns:
+  void Gather() {
+    int n_cells = cells_.size();
+    curr_states_.resize(n_cells);
+    next_states_.resize(n_cells);
+    for (int i = 0; i != n_cells; ++i) {
+      auto& state = cells_[i]->data.state;
+      for (int c = 0; c != kComponents; ++c) {
+        curr_states_[i][c] = GetComponent(&state, c);
+      }
+    }
+  }
+  void Scatter() const {
+    int n_cells = cells_.size();
+    for (int i = 0; i != n_cells; ++i) {
+      auto& state = cells_[i]->data.state;
+      for (int c = 0; c != kComponents; ++c) {
+        GetComponent(&state, c) = curr_states_[i][c];
+      }
+    }
+  }
+  // Advance the columns (but not the cells) by a step, in which d(state)/dt
+  // is given to `steady` (if not nullptr):
+  void Advance(double step_size, Steady<kComponents>* steady) {
+    matrix_.Multiply(curr_states_, &next_states_, n_threads_);
+    if (steady) {
+      int n_cells = cells_.size();
+      for (int i = 0; i != n_cells; ++i) {
+        auto du_dt = next_states_[i];
+        du_dt -= curr_states_[i];
+        du_dt /= step_size;
+        steady->Add(du_dt);
+      }
+    }
+    std::swap(curr_states_, next_states_);
+  }
+
+ private:
+  static double& GetComponent(State* state, int i) {
+    if constexpr (std::is_arithmetic_v<State>) {
+      return *state;
+    } else {
+      return (*state)[i];
+    }
+  }
+  template <class Function>
+  static Block GetBlock(Function&& flux_of_state) {
+    auto block = Block();
+    for (int c = 0; c != kComponents; ++c) {
+      auto state = State{};
+      GetComponent(&state, c) = 1.0;
+      auto flux = flux_of_state(state);
+      for (int r = 0; r != kComponents; ++r) {
+        block[r][c] = GetComponent(&flux, r);
+      }
+    }
+    return block;
+  }
+  struct WallOperator {
+    // flux = positive_block * u_positive + negative_block * u_negative
+    int positive_side{-1}, negative_side{-1};
+    Block positive_block{}, negative_block{};
+  };
+
+  int n_threads_{1};
+  std::vector<Cell*> cells_;
+  Sparse matrix_;
+  std::vector<Column> curr_states_;
+  std::vector<Column> next_states_;
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_LINEAR_HPP_
@@ -0,0 +1,130 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_LU_SGS_HPP_
+#define MINI_MODEL_LU_SGS_HPP_
+
+#include <cassert>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mini/model/steady.hpp"
+#include "mini/model/sweep.hpp"
+
+namespace mini {
+namespace model {
+
+// LU-SGS, which relaxes the backward Euler system once a step by a forward
+// and a backward Gauss-Seidel sweep over cells.  Flux Jacobians are replaced
+// by differences of normal fluxes and by spectral radii from
+// Riemann::GetMaximumSpeed(), so nothing but one increment per cell is
+// stored.  The spectral radii on the diagonal are scaled by `omega`.
+template <class Mesh, class Riemann>
+class LuSgs {
+  using Wall = typename Mesh::Wall;
+  using Cell = typename Mesh::Cell;
+  using State = typename Riemann::State;
+  using Flux = typename Riemann::Flux;
+  using Sweep = model::Sweep<Mesh, Riemann>;
+  static constexpr int kComponents = sizeof(State) / sizeof(double);
+
+ public:
+  // Constructors:
+  LuSgs() = default;
+  explicit LuSgs(double omega) : omega_(omega) {
+    assert(omega > 0);
+  }
+  // Accessors:
+  bool IsEnabled() const { return omega_ > 0; }
+  // Mutators:
+  // Link each of `cells` to its walls in `sweep`:
+  void Link(Sweep const& sweep, std::vector<Cell*> const& cells) {
+    auto wall_to_index = std::unordered_map<Wall const*, int>();
+    int n_walls = sweep.CountWalls();
+    for (int i = 0; i != n_walls; ++i) {
+      wall_to_index.emplace(sweep.GetWall(i), i);
+    }
+    first_wall_ = {0};
+    cell_walls_.clear();
+    for (auto cell : cells) {
+      cell->ForEachWall([&](Wall& wall) {
+        auto sign = wall.GetPositiveSide() == cell ? -1 : +1;
+        cell_walls_.emplace_back(wall_to_index.at(&wall), sign);
+      });
+      first_wall_.emplace_back(cell_walls_.size());
+    }
+  }
+  // Solve (D + L) * du* = b, then (D + U) * du = D * du*, in which b is
+  // measure * R(u), D is (measure / dt + omega / 2 * sum(speed * length)),
+  // and the off-diagonal parts are applied by flux differences.  The dt of
+  // the i-th cell is given by `get_step_size(i)` after wave speeds are
+  // summed, and R(u) is given to `steady` (if not nullptr):
+  template <class StepSize>
+  void Advance(Sweep* sweep, std::vector<Cell*> const& cells,
+               std::vector<double> const& measures, StepSize&& get_step_size,
+               Steady<kComponents>* steady) {
+    sweep->UpdateFluxes();
+    sweep->SumWaveSpeeds();
+    int n = cells.size();
+    increments_.resize(n);
+    diagonals_.resize(n);
+    for (int i = 0; i != n; ++i) {
+      auto rate = Sweep::GetNetFlux(*cells[i]);
+      if (steady) { steady->Add(rate); }
+      auto step_size = get_step_size(i);
+      auto& diagonal = diagonals_[i];
+      diagonal = measures[i] / step_size + 0.5 * omega_ * sweep->GetWaveSum(i);
+      auto& du = increments_[i];
+      du = rate;
+      du *= measures[i];
+      SubtractNeighbors(*sweep, cells, i, /* lower = */true, &du);
+      du /= diagonal;
+    }
+    for (int i = n - 1; i >= 0; --i) {
+      auto sum = Flux{};
+      SubtractNeighbors(*sweep, cells, i, /* lower = */false, &sum);
+      sum /= diagonals_[i];
+      increments_[i] += sum;
+    }
+    for (int i = 0; i != n; ++i) { cells[i]->data.state += increments_[i]; }
+  }
+
+ private:
+  // sum -= (s * dF - speed * du) * length / 2 over the lower (or upper)
+  // neighbors of cell i, in which s makes the normal outward, and dF is the
+  // change of the normal flux by the neighbor's increment du:
+  void SubtractNeighbors(Sweep const& sweep, std::vector<Cell*> const& cells,
+                         int i, bool lower, Flux* sum) const {
+    for (int k = first_wall_[i]; k != first_wall_[i + 1]; ++k) {
+      auto w = cell_walls_[k].first, sign = cell_walls_[k].second;
+      auto positive = sweep.GetCells(w).first;
+      auto negative = sweep.GetCells(w).second;
+      auto j = positive == i ? negative : positive;
+      if (j < 0 || (j < i) != lower) { continue; }
+      auto wall = sweep.GetWall(w);
+      auto& riemann = wall->data.riemann;
+      auto& u_j = cells[j]->data.state;
+      auto& du_j = increments_[j];
+      auto u = u_j;
+      u += du_j;
+      auto df = riemann.GetFluxOnFreeWall(u);
+      df -= riemann.GetFluxOnFreeWall(u_j);
+      df *= -0.5 * sign * wall->Measure();
+      auto damping = du_j;
+      damping *= 0.5 * sweep.GetWaveSpeed(w);
+      *sum -= df;
+      *sum += damping;
+    }
+  }
+
+  double omega_{0.0};
+  std::vector<Flux> increments_;
+  std::vector<double> diagonals_;
+  // Walls of each cell (in CSR form), with the signs of their fluxes:
+  std::vector<int> first_wall_{0};
+  std::vector<std::pair<int, int>> cell_walls_;
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_LU_SGS_HPP_
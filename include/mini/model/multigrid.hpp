@@ -0,0 +1,353 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_MULTIGRID_HPP_
+#define MINI_MODEL_MULTIGRID_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace mini {
+namespace model {
+
+// Full approximation storage (FAS) multigrid on agglomerated cells, which
+// drives a first-order finite volume residual toward zero.  Each coarse cell
+// is a group of neighboring cells on the finer level, and each coarse face
+// merges the faces between two groups (or between a group and a boundary) into
+// one Riemann solver along their summed (normal * length).  Every level is
+// smoothed by explicit local time steps.
+template <class Riemann>
+class Multigrid {
+  using State = typename Riemann::State;
+  using Flux = typename Riemann::Flux;
+  static constexpr int kComponents = sizeof(Flux) / sizeof(double);
+  static constexpr int kMaxHalvings = 8;
+
+ public:
+  // Types:
+  enum class Kind { kTwoSided, kFree, kSolid };
+  struct Face {
+    Riemann riemann;  // rotated to (n1, n2)
+    double n1, n2, length;  // unit normal from positive to negative
+    int positive, negative;  // -1 for the ghost behind a boundary face
+    Kind kind{Kind::kTwoSided};
+  };
+  // Constructors:
+  Multigrid() = default;
+  Multigrid(int max_levels, int gamma, int n_smoothings)
+      : max_levels_(max_levels), gamma_(gamma), n_smoothings_(n_smoothings) {
+    assert(max_levels > 0 && gamma > 0 && n_smoothings > 0);
+  }
+  // Accessors:
+  bool IsEnabled() const { return max_levels_ > 0; }
+  int CountLevels() const { return levels_.size(); }
+  int CountCells(int level) const { return levels_[level].measures.size(); }
+  int CountFaces(int level) const { return levels_[level].faces.size(); }
+  // d(state)/dt of each fine cell at the start of the latest cycle:
+  std::vector<Flux> const& GetFineRates() const { return fine_rates_; }
+  // The L2 norm of the fine residual at the start of the latest cycle over
+  // that at the start of the previous one, i.e. the convergence factor of
+  // the previous cycle (0 before the second cycle):
+  double GetConvergenceFactor() const {
+    return old_norm_ > 0 ? new_norm_ / old_norm_ : 0.0;
+  }
+  // Mutators:
+  // Build coarser levels from the finest one, until `max_levels` levels are
+  // built, or no more cells can be merged:
+  void Build(std::vector<double> measures, std::vector<Face> faces) {
+    levels_.clear();
+    levels_.emplace_back();
+    levels_[0].measures = std::move(measures);
+    levels_[0].faces = std::move(faces);
+    Allocate(&levels_[0]);
+    while (CountLevels() < max_levels_ && Coarsen()) { continue; }
+    old_norm_ = new_norm_ = 0;
+  }
+  // Run one cycle on the fine `states`, in which each level is smoothed by
+  // local time steps of `cfl`:
+  void Cycle(std::vector<State>* states, double cfl) {
+    auto& fine = levels_[0];
+    assert(states->size() == fine.states.size());
+    fine.states.swap(*states);
+    GetRates(&fine, false);
+    fine_rates_ = fine.rates;
+    old_norm_ = new_norm_;
+    new_norm_ = GetNorm(fine_rates_);
+    Visit(0, cfl, true);
+    fine.states.swap(*states);
+  }
+  // Greedily group the cells of a graph into aggregates of a seed and its
+  // free neighbors, in which cells left alone join their smallest neighboring
+  // aggregate.  Return the (compact) index of the aggregate of each cell:
+  static std::vector<int> Agglomerate(
+      int n_cells, std::vector<std::pair<int, int>> const& edges) {
+    auto first = std::vector<int>(n_cells + 1);
+    for (auto& [i, j] : edges) {
+      ++first[i + 1];
+      ++first[j + 1];
+    }
+    for (int i = 0; i != n_cells; ++i) { first[i + 1] += first[i]; }
+    auto neighbors = std::vector<int>(first.back());
+    auto next = std::vector<int>(first.begin(), first.end() - 1);
+    for (auto& [i, j] : edges) {
+      neighbors[next[i]++] = j;
+      neighbors[next[j]++] = i;
+    }
+    auto parents = std::vector<int>(n_cells, -1);
+    auto sizes = std::vector<int>();
+    for (int seed = 0; seed != n_cells; ++seed) {
+      if (parents[seed] >= 0) { continue; }
+      parents[seed] = sizes.size();
+      sizes.emplace_back(1);
+      for (int k = first[seed]; k != first[seed + 1]; ++k) {
+        auto& parent = parents[neighbors[k]];
+        if (parent < 0) {
+          parent = parents[seed];
+          ++sizes.back();
+        }
+      }
+    }
+    for (int i = 0; i != n_cells; ++i) {
+      if (sizes[parents[i]] != 1) { continue; }
+      int best = -1;
+      for (int k = first[i]; k != first[i + 1]; ++k) {
+        auto parent = parents[neighbors[k]];
+        if (parent != parents[i] && (best < 0 || sizes[parent] < sizes[best])) {
+          best = parent;
+        }
+      }
+      if (best >= 0) {
+        --sizes[parents[i]];
+        ++sizes[best];
+        parents[i] = best;
+      }
+    }
+    auto compact = std::vector<int>(sizes.size(), -1);
+    int n_aggregates = 0;
+    for (auto& parent : parents) {
+      if (compact[parent] < 0) { compact[parent] = n_aggregates++; }
+      parent = compact[parent];
+    }
+    return parents;
+  }
+
+ private:
+  struct Level {
+    std::vector<double> measures;
+    std::vector<Face> faces;
+    std::vector<int> parents;  // cells on the next level
+    std::vector<State> states, restricted;
+    std::vector<Flux> rates, forcing;
+    std::vector<double> wave_sums;
+  };
+  static void Allocate(Level* level) {
+    auto n = level->measures.size();
+    level->states.resize(n);
+    level->restricted.resize(n);
+    level->rates.resize(n);
+    level->forcing.assign(n, Flux{});
+    level->wave_sums.resize(n);
+  }
+  // Append a coarser level, and return false if no cell can be merged:
+  bool Coarsen() {
+    auto& fine = levels_.back();
+    auto edges = std::vector<std::pair<int, int>>();
+    for (auto& face : fine.faces) {
+      if (face.kind == Kind::kTwoSided && face.positive != face.negative) {
+        edges.emplace_back(face.positive, face.negative);
+      }
+    }
+    int n_fine = fine.measures.size();
+    auto parents = Agglomerate(n_fine, edges);
+    int n_coarse = parents.empty() ? 0
+        : *std::max_element(parents.begin(), parents.end()) + 1;
+    if (n_coarse == n_fine) { return false; }
+    auto coarse = Level();
+    coarse.measures.assign(n_coarse, 0.0);
+    for (int i = 0; i != n_fine; ++i) {
+      coarse.measures[parents[i]] += fine.measures[i];
+    }
+    // Faces of the same (positive, negative, kind) are merged, unless their
+    // normals point away from each other (e.g. across a periodic boundary):
+    using Key = std::tuple<int, int, Kind>;
+    auto key_to_faces = std::map<Key, std::vector<int>>();
+    for (auto& face : fine.faces) {
+      int a, b = -1;
+      auto sign = 1.0;
+      if (face.kind == Kind::kTwoSided) {
+        a = parents[face.positive];
+        b = parents[face.negative];
+        if (a == b) { continue; }
+        if (a > b) {
+          std::swap(a, b);
+          sign = -1.0;
+        }
+      } else if (face.positive >= 0) {
+        a = parents[face.positive];
+      } else {
+        a = parents[face.negative];
+        sign = -1.0;  // the normal points out of the domain
+      }
+      auto n1 = face.n1 * face.length * sign;
+      auto n2 = face.n2 * face.length * sign;
+      auto& candidates = key_to_faces[{a, b, face.kind}];
+      auto iter = std::find_if(candidates.begin(), candidates.end(),
+          [&](int i) {
+            auto& that = coarse.faces[i];
+            return that.n1 * n1 + that.n2 * n2 > 0;
+          });
+      if (iter == candidates.end()) {
+        candidates.emplace_back(coarse.faces.size());
+        coarse.faces.push_back({face.riemann, 0.0, 0.0, 0.0, a, b, face.kind});
+        iter = candidates.end() - 1;
+      }
+      coarse.faces[*iter].n1 += n1;
+      coarse.faces[*iter].n2 += n2;
+    }
+    for (auto& face : coarse.faces) {
+      face.length = std::hypot(face.n1, face.n2);
+      face.n1 /= face.length;
+      face.n2 /= face.length;
+      face.riemann.Rotate(face.n1, face.n2);
+    }
+    fine.parents = std::move(parents);
+    Allocate(&coarse);
+    levels_.emplace_back(std::move(coarse));
+    return true;
+  }
+  // rates = R(states) (+ forcing if `forced`), and the sums of (largest wave
+  // speed * length) of the faces of each cell:
+  static void GetRates(Level* level, bool forced) {
+    auto& rates = level->rates;
+    std::fill(rates.begin(), rates.end(), Flux{});
+    std::fill(level->wave_sums.begin(), level->wave_sums.end(), 0.0);
+    for (auto& face : level->faces) {
+      auto& riemann = face.riemann;
+      auto ghost = State{};
+      auto get_state = [&](int i, int j) -> State const& {
+        if (i >= 0) { return level->states[i]; }
+        auto const& inner = level->states[j];
+        ghost = face.kind == Kind::kSolid
+            ? riemann.GetStateBehindSolidWall(inner)
+            : riemann.GetStateBehindFreeWall(inner);
+        return ghost;
+      };
+      auto const& u_l = get_state(face.positive, face.negative);
+      auto const& u_r = get_state(face.negative, face.positive);
+      // Solid ghosts only bound wave speeds, as in Godunov:
+      auto flux = face.kind == Kind::kSolid
+          ? riemann.GetFluxOnSolidWall(face.positive >= 0 ? u_l : u_r)
+          : riemann.GetFluxOnTimeAxis(u_l, u_r);
+      flux *= face.length;
+      auto speed = riemann.GetMaximumSpeed(u_l, u_r) * face.length;
+      if (face.positive >= 0) {
+        rates[face.positive] -= flux;
+        level->wave_sums[face.positive] += speed;
+      }
+      if (face.negative >= 0) {
+        rates[face.negative] += flux;
+        level->wave_sums[face.negative] += speed;
+      }
+    }
+    int n = rates.size();
+    for (int i = 0; i != n; ++i) {
+      rates[i] /= level->measures[i];
+      if (forced) { rates[i] += level->forcing[i]; }
+    }
+  }
+  // Take `n_steps` local time steps, in which the first one may reuse
+  // up-to-date rates:
+  static void Smooth(Level* level, double cfl, int n_steps, bool has_rates) {
+    int n = level->states.size();
+    for (int k = 0; k != n_steps; ++k) {
+      if (k || !has_rates) { GetRates(level, true); }
+      for (int i = 0; i != n; ++i) {
+        if (level->wave_sums[i] == 0) { continue; }  // nothing moves
+        auto du = level->rates[i];
+        du *= cfl * level->measures[i] / level->wave_sums[i];
+        AddSafely(&level->states[i], du);
+      }
+    }
+  }
+  // Solve R(u) + forcing = 0 on level `l` (approximately), in which the
+  // coarse level solves its own problem forced by the restricted residual,
+  // and corrects this level by the change of its states:
+  void Visit(int l, double cfl, bool has_rates) {
+    auto& level = levels_[l];
+    if (l + 1 == CountLevels()) {
+      Smooth(&level, cfl, 2 * n_smoothings_, has_rates);
+      return;
+    }
+    Smooth(&level, cfl, n_smoothings_, has_rates);
+    GetRates(&level, true);
+    // Restrict states by averaging, and residuals by summing:
+    auto& coarse = levels_[l + 1];
+    int n_fine = level.states.size(), n_coarse = coarse.states.size();
+    std::fill(coarse.states.begin(), coarse.states.end(), State{});
+    std::fill(coarse.forcing.begin(), coarse.forcing.end(), Flux{});
+    for (int i = 0; i != n_fine; ++i) {
+      auto parent = level.parents[i];
+      auto u = level.states[i];
+      u *= level.measures[i];
+      coarse.states[parent] += u;
+      auto r = level.rates[i];
+      r *= level.measures[i];
+      coarse.forcing[parent] += r;
+    }
+    for (int i = 0; i != n_coarse; ++i) {
+      coarse.states[i] /= coarse.measures[i];
+      coarse.forcing[i] /= coarse.measures[i];
+    }
+    coarse.restricted = coarse.states;
+    // forcing = restricted residual - R(restricted states), so that the
+    // coarse problem is solved by the restricted states of a solution:
+    GetRates(&coarse, false);
+    for (int i = 0; i != n_coarse; ++i) {
+      coarse.forcing[i] -= coarse.rates[i];
+    }
+    for (int k = 0; k != gamma_; ++k) { Visit(l + 1, cfl, false); }
+    // Prolongate the correction by injection:
+    for (int i = 0; i != n_fine; ++i) {
+      auto parent = level.parents[i];
+      auto du = coarse.states[parent];
+      du -= coarse.restricted[parent];
+      AddSafely(&level.states[i], du);
+    }
+    Smooth(&level, cfl, n_smoothings_, false);
+  }
+  // u += du, in which du is halved until u stays admissible (or dropped), as
+  // forcing terms and coarse corrections do not preserve positivity:
+  template <class Increment>
+  static void AddSafely(State* u, Increment du) {
+    for (int k = 0; k != kMaxHalvings; ++k) {
+      auto v = *u;
+      v += du;
+      if (Riemann::IsAdmissible(v)) {
+        *u = v;
+        return;
+      }
+      du *= 0.5;
+    }
+  }
+  static double GetNorm(std::vector<Flux> const& rates) {
+    auto sum = 0.0;
+    for (auto& rate : rates) {
+      auto values = reinterpret_cast<double const*>(&rate);
+      for (int c = 0; c != kComponents; ++c) { sum += values[c] * values[c]; }
+    }
+    return rates.empty() ? 0.0 : std::sqrt(sum / rates.size());
+  }
+
+  std::vector<Level> levels_;
+  std::vector<Flux> fine_rates_;
+  double old_norm_{0}, new_norm_{0};
+  int max_levels_{0}, gamma_{1}, n_smoothings_{1};
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_MULTIGRID_HPP_
@@ -0,0 +1,72 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_RESIDUAL_HPP_
+#define MINI_MODEL_RESIDUAL_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <initializer_list>
+#include <ostream>
+
+namespace mini {
+namespace model {
+
+// L1, L2 and L-infinity norms of the residual d(state)/dt over all cells, one
+// for each component.  L1 and L2 are averaged over cells, so that they do not
+// grow with the size of the mesh.
+template <int kComponents>
+class Residual {
+ public:
+  // Types:
+  using Norms = std::array<double, kComponents>;
+  // Accessors:
+  Norms const& L1() const { return l1_; }
+  Norms const& L2() const { return l2_; }
+  Norms const& LInf() const { return l_inf_; }
+  // Mutators:
+  void Clear() {
+    l1_.fill(0.0);
+    l2_.fill(0.0);
+    l_inf_.fill(0.0);
+    n_cells_ = 0;
+  }
+  // Add the residual of a cell, which is a State-like object of doubles:
+  template <class Flux>
+  void Add(Flux const& du_dt) {
+    static_assert(sizeof(Flux) == sizeof(double) * kComponents);
+    Add(reinterpret_cast<double const*>(&du_dt));
+  }
+  void Add(double const* du_dt) {
+    for (int c = 0; c != kComponents; ++c) {
+      auto value = std::abs(du_dt[c]);
+      l1_[c] += value;
+      l2_[c] += value * value;
+      l_inf_[c] = std::max(l_inf_[c], value);
+    }
+    ++n_cells_;
+  }
+  // Turn the sums into norms:
+  void Finish() {
+    for (int c = 0; c != kComponents && n_cells_; ++c) {
+      l1_[c] /= n_cells_;
+      l2_[c] = std::sqrt(l2_[c] / n_cells_);
+    }
+  }
+  // Write a line of `step` and all norms:
+  void Write(std::ostream& out, int step) const {
+    out << step;
+    for (auto norms : {&l1_, &l2_, &l_inf_}) {
+      for (auto value : *norms) { out << ' ' << value; }
+    }
+    out << '\n';
+  }
+
+ private:
+  Norms l1_{}, l2_{}, l_inf_{};
+  int n_cells_{0};
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_RESIDUAL_HPP_
@@ -0,0 +1,72 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_ROLLBACK_HPP_
+#define MINI_MODEL_ROLLBACK_HPP_
+
+#include <cassert>
+#include <vector>
+
+namespace mini {
+namespace model {
+
+// A ring buffer of the last few healthy states, from which a failed run is
+// restarted with a halved step size.  The step size is doubled back after a
+// whole ring of healthy snapshots is taken at the finer step.
+template <class State>
+class Rollback {
+ public:
+  // Types:
+  struct Snapshot {
+    int step;
+    std::vector<State> states;
+  };
+  // Constructors:
+  Rollback() = default;
+  Rollback(int n_snapshots, int max_halvings)
+      : slots_(n_snapshots), max_halvings_(max_halvings) {
+    assert(n_snapshots > 0 && max_halvings >= 0);
+  }
+  // Accessors:
+  bool IsEnabled() const { return !slots_.empty(); }
+  int CountSnapshots() const { return size_; }
+  int CountHalvings() const { return n_halvings_; }
+  // Mutators:
+  // Take a snapshot by `save(&states)`, which overwrites the oldest one, and
+  // return true if the number of halvings is changed:
+  template <class Saver>
+  bool Save(int step, Saver&& save) {
+    int n_slots = slots_.size();
+    head_ = (head_ + 1) % n_slots;
+    if (size_ < n_slots) { ++size_; }
+    slots_[head_].step = step;
+    save(&slots_[head_].states);
+    if (n_halvings_ && ++n_healthy_ == n_slots) {
+      --n_halvings_;
+      n_healthy_ = 0;
+      return true;
+    }
+    return false;
+  }
+  // Halve the step size once more, or drop the latest snapshot if it cannot
+  // be halved any more, and return the snapshot to restart from (or nullptr
+  // if none is left):
+  Snapshot const* Fail() {
+    n_healthy_ = 0;
+    if (n_halvings_ < max_halvings_) {
+      ++n_halvings_;
+    } else if (size_) {
+      head_ = (head_ + slots_.size() - 1) % slots_.size();
+      --size_;
+    }
+    return size_ ? &slots_[head_] : nullptr;
+  }
+
+ private:
+  std::vector<Snapshot> slots_;
+  int head_{-1}, size_{0};
+  int max_halvings_{0}, n_halvings_{0}, n_healthy_{0};
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_ROLLBACK_HPP_
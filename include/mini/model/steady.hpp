@@ -0,0 +1,83 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_STEADY_HPP_
+#define MINI_MODEL_STEADY_HPP_
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "mini/model/residual.hpp"
+
+namespace mini {
+namespace model {
+
+// The stopping rule of a run toward a steady state, which logs the residual
+// norms of each step, and stops once the L2 norm of every component drops
+// below `tolerance` times its peak, or once the largest such ratio has hit
+// no new low in `stall_steps` steps (0 for never).
+template <int kComponents>
+class Steady {
+ public:
+  // Constructors:
+  Steady() = default;
+  Steady(double tolerance, int stall_steps)
+      : tolerance_(tolerance), stall_steps_(stall_steps), is_enabled_(true) {}
+  // Accessors:
+  bool IsEnabled() const { return is_enabled_; }
+  Residual<kComponents> const& GetResidual() const { return residual_; }
+  // Mutators:
+  // Start a run, whose residual norms are logged in `file_name`:
+  void Start(std::string const& file_name) {
+    log_ = std::ofstream(file_name);
+    log_ << "# step, L1[...], L2[...], LInf[...]\n";
+    best_step_ = -1;
+  }
+  // Start a step, whose d(state)/dt of each cell is given by Add():
+  void Clear() { residual_.Clear(); }
+  template <class Flux>
+  void Add(Flux const& du_dt) { residual_.Add(du_dt); }
+  // Log the residual of this step, and tell if the run should stop:
+  bool IsSteady(int step) {
+    residual_.Finish();
+    residual_.Write(log_, step);
+    auto& l2 = residual_.L2();
+    if (best_step_ < 0) {
+      peak_l2_.fill(0.0);
+      best_ratio_ = 1.0;
+      best_step_ = step;
+    }
+    auto ratio = 0.0;
+    for (int c = 0; c != kComponents; ++c) {
+      peak_l2_[c] = std::max(peak_l2_[c], l2[c]);
+      ratio = std::max(ratio, peak_l2_[c] ? l2[c] / peak_l2_[c] : 0.0);
+    }
+    if (ratio < tolerance_) {
+      std::printf("Converged at step %d, with L2 ratio %g\n", step, ratio);
+      return true;
+    }
+    if (ratio < best_ratio_) {
+      best_ratio_ = ratio;
+      best_step_ = step;
+    } else if (stall_steps_ && step - best_step_ >= stall_steps_) {
+      std::printf("Stalled at step %d, with L2 ratio %g\n", step, best_ratio_);
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  double tolerance_{0.0};
+  int stall_steps_{0};
+  bool is_enabled_{false};
+  Residual<kComponents> residual_;
+  std::ofstream log_;
+  typename Residual<kComponents>::Norms peak_l2_;
+  double best_ratio_{1.0};
+  int best_step_{-1};
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_STEADY_HPP_
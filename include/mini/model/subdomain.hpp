@@ -0,0 +1,265 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_SUBDOMAIN_HPP_
+#define MINI_MODEL_SUBDOMAIN_HPP_
+
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <thread>  // NOLINT(build/c++11)
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mini {
+namespace model {
+
+// A shared-nothing piece of a decomposed domain.  It owns private copies of
+// the states of its cells (followed by ghost copies of its neighbors' cells)
+// and of the Riemann solvers on its walls.  The only data shared between
+// threads are the double-buffered halo messages posted to each neighbor.
+template <class Mesh, class Riemann>
+class Subdomain {
+  using Wall = typename Mesh::Wall;
+  using Cell = typename Mesh::Cell;
+  using State = typename Riemann::State;
+  using Flux = typename Riemann::Flux;
+
+ public:
+  // Types:
+  enum class Kind { kTwoSided, kFree, kSolid };
+  // Constructors:
+  Subdomain() = default;
+  Subdomain(Subdomain const&) = delete;
+  Subdomain& operator=(Subdomain const&) = delete;
+  // Accessors:
+  int CountCells() const { return cells_.size(); }
+  int CountGhosts() const { return states_.size() - cells_.size(); }
+  int CountWalls() const { return walls_.size(); }
+  int CountCutWalls() const { return walls_.size() - n_local_walls_; }
+  // Ghost cells owned by `sender`, in the order of its messages:
+  std::vector<Cell*> const& GetGhosts(Subdomain const* sender) const {
+    return inboxes_.at(sender).ghosts;
+  }
+  template <class Visitor>
+  void ForEachSender(Visitor&& visitor) const {
+    for (auto& [sender, inbox] : inboxes_) { visitor(sender); }
+  }
+  // Mutators (before the first step):
+  void AddCell(Cell* cell) {
+    cell_to_index_.emplace(cell, cells_.size());
+    cells_.emplace_back(cell);
+    states_.emplace_back();
+  }
+  // Add a wall of some owned cell, in which `owner_of(cell)` returns the
+  // subdomain owning a non-owned cell:
+  template <class OwnerOf>
+  void AddWall(Wall const* wall, Kind kind, OwnerOf&& owner_of) {
+    if (wall_to_slot_.count(wall)) { return; }
+    auto local = LocalWall{wall->data.riemann, wall->Measure()};
+    local.positive = GetIndex(wall->GetPositiveSide(), owner_of);
+    local.negative = GetIndex(wall->GetNegativeSide(), owner_of);
+    // Walls touching halo cells are cut, and put into another list:
+    auto is_cut = IsGhost(local.positive) || IsGhost(local.negative);
+    auto& walls = is_cut ? cut_walls_ : walls_;
+    auto slot = Slot{is_cut, static_cast<int>(walls.size())};
+    if (kind != Kind::kTwoSided) {
+      // Boundary walls get ghost states behind them:
+      auto& ghost = local.positive < 0 ? local.positive : local.negative;
+      auto inner = local.positive < 0 ? local.negative : local.positive;
+      ghost = states_.size();
+      states_.emplace_back();
+      boundary_ghosts_.push_back({slot.second, inner, ghost,
+                                  kind == Kind::kSolid});
+    }
+    walls.emplace_back(std::move(local));
+    wall_to_slot_.emplace(wall, slot);
+  }
+  // Send the states of owned `cells` to `receiver` in each step:
+  void AddOutbox(Subdomain const* receiver, std::vector<Cell*> const& cells) {
+    auto& outbox = outboxes_.emplace_back();
+    outbox.receiver = receiver;
+    for (auto cell : cells) {
+      outbox.cells.emplace_back(cell_to_index_.at(cell));
+    }
+    for (auto& buffer : outbox.buffers) { buffer.resize(cells.size()); }
+  }
+  // Put cut walls after local ones, and link each cell to its walls:
+  void Compress() {
+    n_local_walls_ = walls_.size();
+    for (auto& wall : cut_walls_) { walls_.emplace_back(std::move(wall)); }
+    cut_walls_.clear();
+    fluxes_.resize(walls_.size());
+    for (auto cell : cells_) {
+      cell->ForEachWall([&](Wall& wall) {
+        auto slot = wall_to_slot_.at(&wall);
+        auto i = slot.first ? n_local_walls_ + slot.second : slot.second;
+        auto sign = wall.GetPositiveSide() == cell ? -1 : +1;
+        cell_walls_.emplace_back(i, sign);
+      });
+      first_wall_.emplace_back(cell_walls_.size());
+      measures_.emplace_back(cell->Measure());
+    }
+    wall_to_slot_.clear();
+  }
+  // Copy states between the mesh and this subdomain:
+  void Gather() {
+    for (int i = 0; i != cells_.size(); ++i) {
+      states_[i] = cells_[i]->data.state;
+    }
+  }
+  void Scatter() const {
+    for (int i = 0; i != cells_.size(); ++i) {
+      cells_[i]->data.state = states_[i];
+    }
+  }
+  // Advance from `step` to `step + 1`.  Fluxes on local walls are computed
+  // while the halo messages of this step are in flight:
+  void Advance(int step, double step_size) {
+    Post(step);
+    UpdateBoundaryGhosts();
+    for (int i = 0; i != n_local_walls_; ++i) { UpdateWall(i); }
+    UpdateSolidWalls();
+    Receive(step);
+    for (int i = n_local_walls_; i != walls_.size(); ++i) { UpdateWall(i); }
+    UpdateCells(step_size);
+  }
+
+ private:
+  struct LocalWall {
+    LocalWall(Riemann const& riemann, double measure)
+        : riemann(riemann), measure(measure) {}
+    Riemann riemann;
+    double measure;
+    int positive{-1}, negative{-1};
+  };
+  struct BoundaryGhost {
+    int wall, inner, ghost;
+    bool is_solid;
+  };
+  using Slot = std::pair<bool, int>;  // (is_cut, index in its list)
+  struct Outbox {
+    Subdomain const* receiver;
+    std::vector<int> cells;
+    std::array<std::vector<State>, 2> buffers;  // indexed by step parity
+  };
+  struct Inbox {
+    std::vector<Cell*> ghosts;
+    std::vector<int> indices;
+    Outbox const* outbox{nullptr};
+  };
+  template <class OwnerOf>
+  int GetIndex(Cell* cell, OwnerOf&& owner_of) {
+    if (cell == nullptr) { return -1; }
+    auto iter = cell_to_index_.find(cell);
+    if (iter != cell_to_index_.end()) { return iter->second; }
+    // A ghost cell, which is owned by another subdomain:
+    auto& inbox = inboxes_[owner_of(cell)];
+    int index = states_.size();
+    states_.emplace_back();
+    inbox.ghosts.emplace_back(cell);
+    inbox.indices.emplace_back(index);
+    cell_to_index_.emplace(cell, index);
+    return index;
+  }
+  bool IsGhost(int index) const {
+    return index >= static_cast<int>(cells_.size());
+  }
+  void Post(int step) {
+    for (auto& outbox : outboxes_) {
+      auto& buffer = outbox.buffers[step & 1];
+      for (int i = 0; i != outbox.cells.size(); ++i) {
+        buffer[i] = states_[outbox.cells[i]];
+      }
+    }
+    published_.store(step, std::memory_order_release);
+  }
+  // A sender cannot overwrite buffers[step & 1] before this subdomain posts
+  // step + 1, so double buffering is enough.
+  void Receive(int step) {
+    for (auto& [sender, inbox] : inboxes_) {
+      if (inbox.outbox == nullptr) { inbox.outbox = &sender->GetOutbox(this); }
+      while (sender->published_.load(std::memory_order_acquire) < step) {
+        std::this_thread::yield();
+      }
+      auto& buffer = inbox.outbox->buffers[step & 1];
+      for (int i = 0; i != inbox.indices.size(); ++i) {
+        states_[inbox.indices[i]] = buffer[i];
+      }
+    }
+  }
+  Outbox const& GetOutbox(Subdomain const* receiver) const {
+    for (auto& outbox : outboxes_) {
+      if (outbox.receiver == receiver) { return outbox; }
+    }
+    throw std::out_of_range("No message is posted to this `Subdomain`.");
+  }
+  void UpdateBoundaryGhosts() {
+    for (auto& ghost : boundary_ghosts_) {
+      auto& riemann = walls_[ghost.wall].riemann;
+      auto& inner = states_[ghost.inner];
+      if (ghost.is_solid) {
+        states_[ghost.ghost] = riemann.GetStateBehindSolidWall(inner);
+      } else {
+        states_[ghost.ghost] = riemann.GetStateBehindFreeWall(inner);
+      }
+    }
+  }
+  // Solid ghosts are kept for the uniform kernel, but their fluxes are
+  // replaced by GetFluxOnSolidWall(), as Godunov::UpdateEachWall() does:
+  void UpdateSolidWalls() {
+    for (auto& ghost : boundary_ghosts_) {
+      if (!ghost.is_solid) { continue; }
+      auto& wall = walls_[ghost.wall];
+      fluxes_[ghost.wall] = wall.riemann.GetFluxOnSolidWall(
+          states_[ghost.inner]);
+      fluxes_[ghost.wall] *= wall.measure;
+    }
+  }
+  void UpdateWall(int i) {
+    auto& wall = walls_[i];
+    fluxes_[i] = wall.riemann.GetFluxOnTimeAxis(states_[wall.positive],
+                                                states_[wall.negative]);
+    fluxes_[i] *= wall.measure;
+  }
+  void UpdateCells(double step_size) {
+    for (int i = 0; i != cells_.size(); ++i) {
+      auto net_flux = Flux{};
+      for (int k = first_wall_[i]; k != first_wall_[i + 1]; ++k) {
+        auto& flux = fluxes_[cell_walls_[k].first];
+        if (cell_walls_[k].second < 0) {
+          net_flux -= flux;
+        } else {
+          net_flux += flux;
+        }
+      }
+      net_flux /= measures_[i];
+      net_flux *= step_size;
+      states_[i] += net_flux;
+    }
+  }
+
+ private:
+  // Owned cells, whose states are followed by halo and boundary ghosts:
+  std::vector<Cell*> cells_;
+  std::vector<State> states_;
+  std::vector<double> measures_;
+  std::unordered_map<Cell const*, int> cell_to_index_;
+  // Local walls, followed by cut ones after Compress():
+  std::vector<LocalWall> walls_, cut_walls_;
+  std::vector<Flux> fluxes_;
+  int n_local_walls_{0};
+  std::unordered_map<Wall const*, Slot> wall_to_slot_;
+  std::vector<BoundaryGhost> boundary_ghosts_;
+  // Walls of each cell (in CSR form), with the signs of their fluxes:
+  std::vector<int> first_wall_{0};
+  std::vector<std::pair<int, int>> cell_walls_;
+  // Halo exchange:
+  std::vector<Outbox> outboxes_;
+  std::unordered_map<Subdomain const*, Inbox> inboxes_;
+  std::atomic<int> published_{-1};
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_SUBDOMAIN_HPP_
@@ -0,0 +1,190 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_SWEEP_HPP_
+#define MINI_MODEL_SWEEP_HPP_
+
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mini/model/boundary.hpp"
+
+namespace mini {
+namespace model {
+
+// All walls of a mesh in one list, each linked to the states on its two
+// sides, in which boundary walls get ghost states, so that explicit,
+// implicit and LU-SGS steps share one flux kernel.  Two-sided walls come
+// first, then free walls, and then solid walls.
+template <class Mesh, class Riemann>
+class Sweep {
+  using Wall = typename Mesh::Wall;
+  using Cell = typename Mesh::Cell;
+  using State = typename Riemann::State;
+  using Flux = typename Riemann::Flux;
+
+ public:
+  // Types:
+  struct Ghost {
+    Wall* wall;
+    State const* inner;
+    bool is_solid;
+  };
+  // Accessors:
+  int CountWalls() const { return walls_.size(); }
+  int CountTwoSidedWalls() const { return walls_.size() - ghosts_.size(); }
+  Wall* GetWall(int i) const { return walls_[i]; }
+  // The states on the positive and negative sides of the i-th wall:
+  std::pair<State const*, State const*> const& GetSides(int i) const {
+    return sides_[i];
+  }
+  // The ghost behind the i-th wall, or nullptr for a two-sided wall:
+  Ghost const* GetGhost(int i) const {
+    int n_two_sided = CountTwoSidedWalls();
+    return i < n_two_sided ? nullptr : &ghosts_[i - n_two_sided];
+  }
+  // The indices of the cells beside the i-th wall (-1 for ghosts):
+  std::pair<int, int> const& GetCells(int i) const { return wall_cells_[i]; }
+  // (largest wave speed * length) of the i-th wall, and its sum over the
+  // walls of the i-th cell, by the latest SumWaveSpeeds():
+  double GetWaveSpeed(int i) const { return wave_speeds_[i]; }
+  double GetWaveSum(int i_cell) const { return wave_sums_[i_cell]; }
+  // The flux on a boundary wall, whose ghost state is made on the fly:
+  static Flux GetFluxOnBoundary(Riemann* riemann, State const& inner,
+                                bool is_solid, bool inner_is_positive) {
+    if (is_solid) { return riemann->GetFluxOnSolidWall(inner); }
+    auto outer = riemann->GetStateBehindFreeWall(inner);
+    return inner_is_positive ? riemann->GetFluxOnTimeAxis(inner, outer)
+                             : riemann->GetFluxOnTimeAxis(outer, inner);
+  }
+  // d(state)/dt of a cell, by the fluxes on its walls, in which `AnyCell`
+  // may be a concrete type, whose Measure() is statically bound:
+  template <class AnyCell>
+  static Flux GetNetFlux(AnyCell const& cell) {
+    auto net_flux = Flux{};
+    cell.ForEachWall([&](Wall const& wall) {
+      if (wall.GetPositiveSide() == &cell) {
+        net_flux -= wall.data.flux;
+      } else {
+        net_flux += wall.data.flux;
+      }
+    });
+    net_flux /= cell.Measure();
+    return net_flux;
+  }
+  // Mutators:
+  void Link(Manager<Mesh>* manager) {
+    walls_.clear();
+    sides_.clear();
+    ghosts_.clear();
+    auto add_two_sided = [&](Wall* wall) {
+      walls_.emplace_back(wall);
+      sides_.emplace_back(&wall->GetPositiveSide()->data.state,
+                          &wall->GetNegativeSide()->data.state);
+    };
+    manager->ForEachInteriorWall(add_two_sided);
+    auto add_one_sided = [&](Wall* wall, bool is_solid) {
+      auto inner = wall->GetPositiveSide() ? wall->GetPositiveSide()
+                                           : wall->GetNegativeSide();
+      ghosts_.push_back({wall, &inner->data.state, is_solid});
+    };
+    manager->ForEachFreeWall([&](Wall* wall) {
+      add_one_sided(wall, false);
+    });
+    manager->ForEachSolidWall([&](Wall* wall) {
+      add_one_sided(wall, true);
+    });
+    // Ghost states never move after this point:
+    ghost_states_.resize(ghosts_.size());
+    first_solid_wall_ = walls_.size();
+    int n_ghosts = ghosts_.size();
+    for (int i = 0; i != n_ghosts; ++i) {
+      auto wall = ghosts_[i].wall;
+      walls_.emplace_back(wall);
+      if (wall->GetPositiveSide()) {
+        sides_.emplace_back(ghosts_[i].inner, &ghost_states_[i]);
+      } else {
+        sides_.emplace_back(&ghost_states_[i], ghosts_[i].inner);
+      }
+      if (!ghosts_[i].is_solid) { ++first_solid_wall_; }
+    }
+  }
+  // Cells are fixed, and so are those beside each wall:
+  void LinkToCells(std::unordered_map<Cell const*, int> const& cell_to_index) {
+    wall_cells_.clear();
+    for (auto wall : walls_) {
+      auto get_index = [&](Cell const* cell) {
+        return cell ? cell_to_index.at(cell) : -1;
+      };
+      wall_cells_.emplace_back(get_index(wall->GetPositiveSide()),
+                               get_index(wall->GetNegativeSide()));
+    }
+    wave_sums_.resize(cell_to_index.size());
+  }
+  // Update the flux (times length) on each wall:
+  void UpdateFluxes() {
+    UpdateGhostStates();
+    for (int i = 0; i != first_solid_wall_; ++i) {
+      auto wall = walls_[i];
+      auto& riemann = wall->data.riemann;
+      auto const& u_l = *sides_[i].first;
+      auto const& u_r = *sides_[i].second;
+      wall->data.flux = riemann.GetFluxOnTimeAxis(u_l, u_r);
+      wall->data.flux *= wall->Measure();
+    }
+    // Solid ghosts only bound wave speeds, since the flux against them may
+    // not vanish (e.g. F(u, -u) = |a| * u for linear models):
+    int n_two_sided = CountTwoSidedWalls();
+    for (int i = first_solid_wall_; i != CountWalls(); ++i) {
+      auto wall = walls_[i];
+      auto& ghost = ghosts_[i - n_two_sided];
+      wall->data.flux = wall->data.riemann.GetFluxOnSolidWall(*ghost.inner);
+      wall->data.flux *= wall->Measure();
+    }
+  }
+  // Sum (largest wave speed * length) of the walls of each cell, on the
+  // current states (and the ghost states of the latest UpdateFluxes()):
+  void SumWaveSpeeds() {
+    std::fill(wave_sums_.begin(), wave_sums_.end(), 0.0);
+    int n_walls = CountWalls();
+    wave_speeds_.resize(n_walls);
+    for (int i = 0; i != n_walls; ++i) {
+      auto wall = walls_[i];
+      auto& speed = wave_speeds_[i];
+      speed = wall->data.riemann.GetMaximumSpeed(*sides_[i].first,
+                                                 *sides_[i].second);
+      speed *= wall->Measure();
+      for (auto i_cell : {wall_cells_[i].first, wall_cells_[i].second}) {
+        if (i_cell >= 0) { wave_sums_[i_cell] += speed; }
+      }
+    }
+  }
+
+ private:
+  void UpdateGhostStates() {
+    int n_ghosts = ghosts_.size();
+    for (int i = 0; i != n_ghosts; ++i) {
+      auto& ghost = ghosts_[i];
+      auto& riemann = ghost.wall->data.riemann;
+      if (ghost.is_solid) {
+        ghost_states_[i] = riemann.GetStateBehindSolidWall(*ghost.inner);
+      } else {
+        ghost_states_[i] = riemann.GetStateBehindFreeWall(*ghost.inner);
+      }
+    }
+  }
+
+  std::vector<Wall*> walls_;
+  std::vector<std::pair<State const*, State const*>> sides_;
+  std::vector<Ghost> ghosts_;
+  std::vector<State> ghost_states_;
+  int first_solid_wall_{0};  // in walls_, after two-sided and free ones
+  std::vector<std::pair<int, int>> wall_cells_;  // (positive, negative)
+  std::vector<double> wave_speeds_;
+  std::vector<double> wave_sums_;
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_SWEEP_HPP_
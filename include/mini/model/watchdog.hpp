@@ -0,0 +1,122 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_MODEL_WATCHDOG_HPP_
+#define MINI_MODEL_WATCHDOG_HPP_
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mini {
+namespace model {
+
+// Thrown when some state goes non-finite or inadmissible, whose message
+// reports the offending cells:
+class Blowup : public std::runtime_error {
+ public:
+  // Constructors:
+  Blowup(int step, std::string const& report)
+      : std::runtime_error(report), step_(step) {}
+  // Accessors:
+  int GetStep() const { return step_; }
+
+ private:
+  int step_;
+};
+
+// A cheap health check of states, which is run every `period` steps.  A state
+// is healthy if all its components are finite and `Riemann::IsAdmissible()`
+// accepts it (e.g. has positive density and pressure).
+template <class Riemann>
+class Watchdog {
+  using State = typename Riemann::State;
+  static constexpr int kComponents = sizeof(State) / sizeof(double);
+  static_assert(sizeof(State) == kComponents * sizeof(double));
+
+ public:
+  // Constructors:
+  Watchdog() = default;
+  Watchdog(int period, int max_reports)
+      : period_(period), max_reports_(max_reports) {}
+  // Accessors:
+  bool IsDue(int step) const { return period_ > 0 && step % period_ == 0; }
+  bool IsEnabled() const { return period_ > 0; }
+  int CountMaxReports() const { return max_reports_; }
+  // Check contiguous states, in which non-finite values are found without
+  // branches (since inf * 0 and nan * 0 are nan), so the loop vectorizes:
+  static bool AreHealthy(State const* states, std::size_t n) {
+    auto values = reinterpret_cast<double const*>(states);
+    auto probe = 0.0;
+    for (std::size_t i = 0; i != n * kComponents; ++i) {
+      probe += values[i] * 0.0;
+    }
+    if (probe != 0.0) { return false; }
+    for (std::size_t i = 0; i != n; ++i) {
+      if (!Riemann::IsAdmissible(states[i])) { return false; }
+    }
+    return true;
+  }
+  static bool IsHealthy(State const& state) {
+    return AreHealthy(&state, 1);
+  }
+  // Report up to CountMaxReports() of `bad_states` at `step`, each of which
+  // is a (cell, member) whose state is `state_of(cell, member)`, along with
+  // the states of its neighbors.  Members are shown if `has_members`:
+  template <class Cell, class StateOf>
+  std::string Report(int step,
+                     std::vector<std::pair<Cell const*, int>> const& bad_states,
+                     StateOf&& state_of, bool has_members) const {
+    auto report = std::ostringstream();
+    report << bad_states.size() << " unhealthy state(s) at step " << step
+           << ":\n";
+    int n_bad = bad_states.size();
+    int n = std::min(n_bad, max_reports_);
+    for (int k = 0; k != n; ++k) {
+      auto& cell = *bad_states[k].first;
+      auto member = bad_states[k].second;
+      auto center = cell.Center();
+      report << "  cell " << cell.I();
+      if (has_members) { report << " (member " << member << ")"; }
+      report << " at (" << center.X() << ", " << center.Y() << "): "
+             << ToString(state_of(cell, member)) << "\n";
+      using Wall = typename Cell::Wall;
+      cell.ForEachWall([&](Wall const& wall) {
+        auto that = wall.GetPositiveSide() == &cell ? wall.GetNegativeSide()
+                                                    : wall.GetPositiveSide();
+        if (that) {
+          report << "    neighbor " << that->I() << ": "
+                 << ToString(state_of(*that, member)) << "\n";
+        } else {
+          report << "    boundary wall at (" << wall.Center().X() << ", "
+                 << wall.Center().Y() << ")\n";
+        }
+      });
+    }
+    if (n < n_bad) {
+      report << "  ... and " << n_bad - n << " more\n";
+    }
+    return report.str();
+  }
+  static std::string ToString(State const& state) {
+    auto values = reinterpret_cast<double const*>(&state);
+    auto text = std::ostringstream();
+    text << "[";
+    for (int i = 0; i != kComponents; ++i) {
+      text << (i ? ", " : "") << values[i];
+    }
+    text << "]";
+    return text.str();
+  }
+
+ private:
+  int period_{0};
+  int max_reports_{8};
+};
+
+}  // namespace model
+}  // namespace mini
+
+#endif  // MINI_MODEL_WATCHDOG_HPP_
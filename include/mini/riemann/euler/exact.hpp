@@ -81,12 +81,15 @@ class Implementor {
 
  private:
   // Helper method and class for the star region:
+  static constexpr int kMaxIterations = 64;
   template <class F, class Fprime>
   static double FindRoot(F&& f, Fprime&& f_prime, double x, double eps = 1e-8) {
     while (f(x) > 0) {
       x *= 0.5;
     }
-    while (f(x) < -eps) {
+    // A failed root finding gives a NaN, which is caught by the watchdog:
+    for (int i = 0; f(x) < -eps; ++i) {
+      if (i == kMaxIterations) { return std::nan(""); }
       x -= f(x) / f_prime(x);
     }
     assert(std::abs(f(x)) < eps);
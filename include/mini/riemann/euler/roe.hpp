@@ -0,0 +1,176 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#ifndef MINI_RIEMANN_EULER_ROE_HPP_
+#define MINI_RIEMANN_EULER_ROE_HPP_
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+#include "mini/riemann/euler/types.hpp"
+
+namespace mini {
+namespace riemann {
+namespace euler {
+
+// Harten-Hyman entropy fix: smooth |lambda| near zero inside a sonic wave.
+inline double GetFixedSpeed(double lambda, double lambda_l, double lambda_r) {
+  double delta = std::max({0.0, lambda - lambda_l, lambda_r - lambda});
+  double lambda_abs = std::abs(lambda);
+  if (lambda_abs < delta) {
+    lambda_abs = (lambda * lambda + delta * delta) / (2 * delta);
+  }
+  return lambda_abs;
+}
+
+template <class GasModel, int kDim = 1>
+class Roe;
+template <class GasModel>
+class Roe<GasModel, 1> {
+ public:
+  // Types:
+  using Gas = GasModel;
+  using Conservative = Conservative<1>;
+  using Primitive = Primitive<1>;
+  using State = Primitive;
+  using Flux = Flux<1>;
+  using Scalar = typename State::Scalar;
+  using Vector = typename State::Vector;
+  using Speed = Scalar;
+  // Get F on T Axia
+  Flux GetFluxOnTimeAxis(State const& left, State const& right) {
+    Initialize(left, right);
+    Flux flux = GetFlux(left);
+    flux += GetFlux(right);
+    // Subtract the upwind dissipation of each wave:
+    auto a_left = Gas::GetSpeedOfSound(left);
+    auto a_right = Gas::GetSpeedOfSound(right);
+    auto d_rho = right.rho() - left.rho();
+    auto d_u = right.u() - left.u();
+    auto d_p = right.p() - left.p();
+    auto a_square = a_ * a_;
+    // Wave[1]: u - a
+    auto alpha = (d_p - rho_ * a_ * d_u) / (2 * a_square);
+    alpha *= GetFixedSpeed(u_ - a_, left.u() - a_left, right.u() - a_right);
+    flux -= Flux{alpha, alpha * (u_ - a_), alpha * (h_ - u_ * a_)};
+    // Wave[2]: u
+    alpha = (d_rho - d_p / a_square) * std::abs(u_);
+    flux -= Flux{alpha, alpha * u_, alpha * u_ * u_ * 0.5};
+    // Wave[3]: u + a
+    alpha = (d_p + rho_ * a_ * d_u) / (2 * a_square);
+    alpha *= GetFixedSpeed(u_ + a_, left.u() + a_left, right.u() + a_right);
+    flux -= Flux{alpha, alpha * (u_ + a_), alpha * (h_ + u_ * a_)};
+    flux *= 0.5;
+    return flux;
+  }
+  // Get F of U
+  Flux GetFlux(State const& state) {
+    auto rho_u = state.rho() * state.u();
+    auto rho_u_u = rho_u * state.u();
+    return {rho_u, rho_u_u + state.p(),
+            state.u() * (state.p() * Gas::GammaOverGammaMinusOne()
+                       + 0.5 * rho_u_u)};
+  }
+
+ private:
+  // Roe-averaged quantities:
+  Scalar rho_;
+  Speed u_;
+  Scalar h_;
+  Speed a_;
+  void Initialize(State const& left, State const& right) {
+    double w_left = std::sqrt(left.rho());
+    double w_right = std::sqrt(right.rho());
+    double w_sum = w_left + w_right;
+    rho_ = w_left * w_right;
+    u_ = (w_left * left.u() + w_right * right.u()) / w_sum;
+    h_ = (w_left * GetEnthalpy(left) + w_right * GetEnthalpy(right)) / w_sum;
+    a_ = std::sqrt(Gas::GammaMinusOne() * (h_ - 0.5 * u_ * u_));
+  }
+  static double GetEnthalpy(State const& state) {
+    return state.p() * Gas::GammaOverGammaMinusOne() / state.rho()
+         + 0.5 * state.u() * state.u();
+  }
+};
+
+template <class GasModel>
+class Roe<GasModel, 2> {
+ public:
+  // Types:
+  using Gas = GasModel;
+  using Conservative = Conservative<2>;
+  using Primitive = Primitive<2>;
+  using State = Primitive;
+  using Flux = Flux<2>;
+  using Scalar = typename State::Scalar;
+  using Vector = typename State::Vector;
+  using Speed = Scalar;
+  // Get F on T Axia
+  Flux GetFluxOnTimeAxis(State const& left, State const& right) {
+    Initialize(left, right);
+    Flux flux = GetFlux(left);
+    flux += GetFlux(right);
+    // Subtract the upwind dissipation of each wave:
+    auto a_left = Gas::GetSpeedOfSound(left);
+    auto a_right = Gas::GetSpeedOfSound(right);
+    auto d_rho = right.rho() - left.rho();
+    auto d_u = right.u() - left.u();
+    auto d_v = right.v() - left.v();
+    auto d_p = right.p() - left.p();
+    auto a_square = a_ * a_;
+    // Wave[1]: u - a
+    auto alpha = (d_p - rho_ * a_ * d_u) / (2 * a_square);
+    alpha *= GetFixedSpeed(u_ - a_, left.u() - a_left, right.u() - a_right);
+    flux -= Flux{alpha, alpha * (u_ - a_), alpha * v_, alpha * (h_ - u_ * a_)};
+    // Wave[2]: u (entropy)
+    alpha = (d_rho - d_p / a_square) * std::abs(u_);
+    flux -= Flux{alpha, alpha * u_, alpha * v_,
+                 alpha * (u_ * u_ + v_ * v_) * 0.5};
+    // Wave[3]: u (shear)
+    alpha = rho_ * d_v * std::abs(u_);
+    flux -= Flux{0.0, 0.0, alpha, alpha * v_};
+    // Wave[4]: u + a
+    alpha = (d_p + rho_ * a_ * d_u) / (2 * a_square);
+    alpha *= GetFixedSpeed(u_ + a_, left.u() + a_left, right.u() + a_right);
+    flux -= Flux{alpha, alpha * (u_ + a_), alpha * v_, alpha * (h_ + u_ * a_)};
+    flux *= 0.5;
+    return flux;
+  }
+  // Get F of U
+  Flux GetFlux(State const& state) {
+    auto rho_u = state.rho() * state.u();
+    auto rho_v = state.rho() * state.v();
+    auto rho_u_u = rho_u * state.u();
+    return {rho_u, rho_u_u + state.p(), rho_v * state.u(),
+            state.u() * (state.p() * Gas::GammaOverGammaMinusOne()
+                       + 0.5 * (rho_u_u + rho_v * state.v()))};
+  }
+
+ private:
+  // Roe-averaged quantities:
+  Scalar rho_;
+  Speed u_;
+  Speed v_;
+  Scalar h_;
+  Speed a_;
+  void Initialize(State const& left, State const& right) {
+    double w_left = std::sqrt(left.rho());
+    double w_right = std::sqrt(right.rho());
+    double w_sum = w_left + w_right;
+    rho_ = w_left * w_right;
+    u_ = (w_left * left.u() + w_right * right.u()) / w_sum;
+    v_ = (w_left * left.v() + w_right * right.v()) / w_sum;
+    h_ = (w_left * GetEnthalpy(left) + w_right * GetEnthalpy(right)) / w_sum;
+    a_ = std::sqrt(Gas::GammaMinusOne() * (h_ - 0.5 * (u_ * u_ + v_ * v_)));
+  }
+  static double GetEnthalpy(State const& state) {
+    return state.p() * Gas::GammaOverGammaMinusOne() / state.rho()
+         + 0.5 * (state.u() * state.u() + state.v() * state.v());
+  }
+};
+
+}  //  namespace euler
+}  //  namespace riemann
+}  //  namespace mini
+
+#endif  //  MINI_RIEMANN_EULER_ROE_HPP_
@@ -0,0 +1,93 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#ifndef MINI_RIEMANN_EULER_RUSANOV_HPP_
+#define MINI_RIEMANN_EULER_RUSANOV_HPP_
+
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+#include "mini/riemann/euler/types.hpp"
+
+namespace mini {
+namespace riemann {
+namespace euler {
+
+template <class GasModel, int kDim = 1>
+class Rusanov;
+template <class GasModel>
+class Rusanov<GasModel, 1> {
+ public:
+  // Types:
+  using Gas = GasModel;
+  using Conservative = Conservative<1>;
+  using Primitive = Primitive<1>;
+  using State = Primitive;
+  using Flux = Flux<1>;
+  using Scalar = typename State::Scalar;
+  using Vector = typename State::Vector;
+  using Speed = Scalar;
+  // Get F on T Axia
+  Flux GetFluxOnTimeAxis(State const& left, State const& right) {
+    auto speed = std::max(std::abs(left.u()) + Gas::GetSpeedOfSound(left),
+                          std::abs(right.u()) + Gas::GetSpeedOfSound(right));
+    Flux flux = GetFlux(left);
+    flux += GetFlux(right);
+    Conservative jump = Gas::PrimitiveToConservative(right);
+    jump -= Gas::PrimitiveToConservative(left);
+    jump *= speed;
+    flux -= jump;
+    flux *= 0.5;
+    return flux;
+  }
+  // Get F of U
+  Flux GetFlux(State const& state) {
+    auto rho_u = state.rho() * state.u();
+    auto rho_u_u = rho_u * state.u();
+    return {rho_u, rho_u_u + state.p(),
+            state.u() * (state.p() * Gas::GammaOverGammaMinusOne()
+                       + 0.5 * rho_u_u)};
+  }
+};
+
+template <class GasModel>
+class Rusanov<GasModel, 2> {
+ public:
+  // Types:
+  using Gas = GasModel;
+  using Conservative = Conservative<2>;
+  using Primitive = Primitive<2>;
+  using State = Primitive;
+  using Flux = Flux<2>;
+  using Scalar = typename State::Scalar;
+  using Vector = typename State::Vector;
+  using Speed = Scalar;
+  // Get F on T Axia
+  Flux GetFluxOnTimeAxis(State const& left, State const& right) {
+    auto speed = std::max(std::abs(left.u()) + Gas::GetSpeedOfSound(left),
+                          std::abs(right.u()) + Gas::GetSpeedOfSound(right));
+    Flux flux = GetFlux(left);
+    flux += GetFlux(right);
+    Conservative jump = Gas::PrimitiveToConservative(right);
+    jump -= Gas::PrimitiveToConservative(left);
+    jump *= speed;
+    flux -= jump;
+    flux *= 0.5;
+    return flux;
+  }
+  // Get F of U
+  Flux GetFlux(State const& state) {
+    auto rho_u = state.rho() * state.u();
+    auto rho_v = state.rho() * state.v();
+    auto rho_u_u = rho_u * state.u();
+    return {rho_u, rho_u_u + state.p(), rho_v * state.u(),
+            state.u() * (state.p() * Gas::GammaOverGammaMinusOne()
+                       + 0.5 * (rho_u_u + rho_v * state.v()))};
+  }
+};
+
+}  //  namespace euler
+}  //  namespace riemann
+}  //  namespace mini
+
+#endif  //  MINI_RIEMANN_EULER_RUSANOV_HPP_
@@ -3,6 +3,7 @@
 #ifndef MINI_RIEMANN_LINEAR_DOUBLE_HPP_
 #define MINI_RIEMANN_LINEAR_DOUBLE_HPP_
 
+#include <algorithm>
 #include <cmath>
 #include <array>
 
@@ -25,6 +26,7 @@ class Double {
   using Coefficient = algebra::Column<Jacobi, kDim>;
   using State = Column;
   using Flux = Column;
+  static constexpr bool IsLinear() { return true; }
   // Constructor:
   Double() = default;
   explicit Double(Jacobi const& a_const) : a_const_(a_const) { Decompose(); }
@@ -44,6 +46,10 @@ class Double {
   Flux GetFlux(State const& state) const {
     return a_const_ * state;
   }
+  // Get the largest wave speed
+  Scalar GetMaximumSpeed(State const& left, State const& right) const {
+    return std::max(std::abs(eigen_values_[0]), std::abs(eigen_values_[1]));
+  }
 
  private:
   State FluxInsideSector(State const& left, State const& right, int k) const {
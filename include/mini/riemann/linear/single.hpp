@@ -24,6 +24,7 @@ class Single {
   using State = double;
   using Flux = double;
   using Speed = double;
+  static constexpr bool IsLinear() { return true; }
   // Constructor:
   Single() : a_const_(1) {}
   explicit Single(Jacobi const& a_const) : a_const_(a_const) {}
@@ -37,6 +38,10 @@ class Single {
   }
   // Get F of U
   Flux GetFlux(State const& state) const { return state * a_const_ ; }
+  // Get the largest wave speed
+  Speed GetMaximumSpeed(State const& left, State const& right) const {
+    return std::abs(a_const_);
+  }
 
  private:
   Jacobi a_const_;
@@ -0,0 +1,277 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#ifndef MINI_RIEMANN_LINEAR_SYSTEM_HPP_
+#define MINI_RIEMANN_LINEAR_SYSTEM_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "mini/algebra/column.hpp"
+#include "mini/algebra/matrix.hpp"
+
+namespace mini {
+namespace riemann {
+namespace linear {
+
+template <int kSize>
+class System {
+ public:
+  static constexpr int kDim = 2;
+  // Types:
+  using Scalar = double;
+  using Vector = algebra::Column<double, kDim>;
+  using Column = algebra::Column<double, kSize>;
+  using Row = Column;
+  using Matrix = algebra::Matrix<double, kSize, kSize>;
+  using Jacobi = Matrix;
+  using Coefficient = algebra::Column<Jacobi, kDim>;
+  using State = Column;
+  using Flux = Column;
+  static constexpr bool IsLinear() { return true; }
+  // Constructor:
+  System() = default;
+  explicit System(Jacobi const& a_const) : a_const_(a_const) { Decompose(); }
+  // Get F on T Axia
+  Flux GetFluxOnTimeAxis(State const& left, State const& right) const {
+    Flux flux;
+    for (int r = 0; r != kSize; ++r) {
+      Scalar f{0};
+      for (int c = 0; c != kSize; ++c) {
+        f += a_positive_[r][c] * left[c] + a_negative_[r][c] * right[c];
+      }
+      flux[r] = f;
+    }
+    return flux;
+  }
+  // Get F of U
+  Flux GetFlux(State const& state) const {
+    Flux flux;
+    for (int r = 0; r != kSize; ++r) {
+      Scalar f{0};
+      for (int c = 0; c != kSize; ++c) {
+        f += a_const_[r][c] * state[c];
+      }
+      flux[r] = f;
+    }
+    return flux;
+  }
+  // Get the largest wave speed
+  Scalar GetMaximumSpeed(State const& left, State const& right) const {
+    Scalar speed{0};
+    for (auto lambda : eigen_values_) {
+      speed = std::max(speed, std::abs(lambda));
+    }
+    return speed;
+  }
+  // Accessors:
+  Column const& GetEigenValues() const { return eigen_values_; }
+  Matrix const& GetEigenMatrixR() const { return eigen_matrix_r_; }
+  Matrix const& GetEigenMatrixL() const { return eigen_matrix_l_; }
+
+ private:
+  void Decompose() {
+    GetEigenValues(a_const_);
+    GetEigenVectors();
+    GetInverseEigenVectors();
+    // A^+ = R * max(Lambda, 0) * L, A^- = R * min(Lambda, 0) * L
+    for (int r = 0; r != kSize; ++r) {
+      for (int c = 0; c != kSize; ++c) {
+        Scalar positive{0}, negative{0};
+        for (int k = 0; k != kSize; ++k) {
+          auto temp = eigen_matrix_r_[r][k] * eigen_matrix_l_[k][c];
+          if (eigen_values_[k] > 0) {
+            positive += temp * eigen_values_[k];
+          } else {
+            negative += temp * eigen_values_[k];
+          }
+        }
+        a_positive_[r][c] = positive;
+        a_negative_[r][c] = negative;
+      }
+    }
+  }
+  Scalar GetTolerance() const {
+    Scalar norm{0};
+    for (auto& row : a_const_) {
+      for (auto& x : row) { norm = std::max(norm, std::abs(x)); }
+    }
+    return std::max(norm, 1.0) * 1e-10;
+  }
+  // Shifted QR iterations, assuming all eigenvalues are real (hyperbolic):
+  void GetEigenValues(Matrix a) {
+    auto eps = GetTolerance() * 1e-3;
+    HessenbergReduce(&a);
+    int n = kSize, n_steps = 0;
+    while (n > 2) {
+      if (std::abs(a[n-1][n-2]) < eps) {
+        eigen_values_[n-1] = a[n-1][n-1];
+        --n;
+        n_steps = 0;
+        continue;
+      }
+      auto mu = GetWilkinsonShift(a[n-2][n-2], a[n-2][n-1],
+                                  a[n-1][n-2], a[n-1][n-1]);
+      if (++n_steps % 16 == 0) {  // Exceptional shift to break a cycle.
+        mu += std::abs(a[n-1][n-2]);
+      }
+      for (int i = 0; i != n; ++i) { a[i][i] -= mu; }
+      QrStep(&a, n);
+      for (int i = 0; i != n; ++i) { a[i][i] += mu; }
+    }
+    if (n == 2) {
+      auto b = a[0][0] + a[1][1];
+      auto c = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+      auto delta = std::sqrt(std::max(b * b - 4 * c, 0.0));
+      eigen_values_[0] = (b - delta) / 2;
+      eigen_values_[1] = (b + delta) / 2;
+    } else {
+      eigen_values_[0] = a[0][0];
+    }
+    std::sort(eigen_values_.begin(), eigen_values_.end());
+  }
+  static Scalar GetWilkinsonShift(Scalar a, Scalar b, Scalar c, Scalar d) {
+    auto half_trace = (a + d) / 2;
+    auto discriminant = (a - d) * (a - d) / 4 + b * c;
+    if (discriminant < 0) { return d; }
+    auto root = std::sqrt(discriminant);
+    auto lambda_1 = half_trace - root, lambda_2 = half_trace + root;
+    return std::abs(lambda_1 - d) < std::abs(lambda_2 - d) ?
+           lambda_1 : lambda_2;
+  }
+  static void Rotate(Matrix* a, int i, int j, Scalar c, Scalar s, int n) {
+    auto& m = *a;
+    for (int k = 0; k != n; ++k) {  // rows
+      auto p = m[i][k], q = m[j][k];
+      m[i][k] = c * p + s * q;
+      m[j][k] = c * q - s * p;
+    }
+  }
+  // Similarity transforms by Givens rotations, which keep eigenvalues:
+  static void HessenbergReduce(Matrix* a) {
+    auto& m = *a;
+    for (int k = 0; k + 2 < kSize; ++k) {
+      for (int i = kSize - 1; i > k + 1; --i) {
+        auto x = m[i-1][k], y = m[i][k];
+        if (y == 0) { continue; }
+        auto r = std::hypot(x, y);
+        auto c = x / r, s = y / r;
+        Rotate(a, i-1, i, c, s, kSize);
+        for (int j = 0; j != kSize; ++j) {  // columns
+          auto p = m[j][i-1], q = m[j][i];
+          m[j][i-1] = c * p + s * q;
+          m[j][i] = c * q - s * p;
+        }
+      }
+    }
+  }
+  // A = Q * R (by Givens rotations), then A = R * Q on the leading block.
+  static void QrStep(Matrix* a, int n) {
+    auto& m = *a;
+    std::array<std::pair<Scalar, Scalar>, kSize> rotations;
+    for (int k = 0; k + 1 < n; ++k) {
+      auto x = m[k][k], y = m[k+1][k];
+      auto r = std::hypot(x, y);
+      auto c = r == 0 ? 1.0 : x / r, s = r == 0 ? 0.0 : y / r;
+      rotations[k] = {c, s};
+      Rotate(a, k, k+1, c, s, n);
+    }
+    for (int k = 0; k + 1 < n; ++k) {
+      auto c = rotations[k].first, s = rotations[k].second;
+      for (int i = 0; i != n; ++i) {
+        auto p = m[i][k], q = m[i][k+1];
+        m[i][k] = c * p + s * q;
+        m[i][k+1] = c * q - s * p;
+      }
+    }
+  }
+  // Fill the columns of R by the null space of (A - lambda * I):
+  void GetEigenVectors() {
+    auto eps = GetTolerance();
+    int k = 0;
+    while (k != kSize) {
+      auto lambda = eigen_values_[k];
+      auto m = a_const_;
+      for (int i = 0; i != kSize; ++i) { m[i][i] -= lambda; }
+      // Reduce to row echelon form with partial pivoting:
+      std::array<int, kSize> pivot_of_column;
+      pivot_of_column.fill(-1);
+      int rank = 0;
+      for (int c = 0; c != kSize && rank != kSize; ++c) {
+        int p = rank;
+        for (int r = rank + 1; r != kSize; ++r) {
+          if (std::abs(m[r][c]) > std::abs(m[p][c])) { p = r; }
+        }
+        if (std::abs(m[p][c]) < eps) { continue; }
+        std::swap(m[p], m[rank]);
+        auto pivot = m[rank][c];
+        for (auto& x : m[rank]) { x /= pivot; }
+        for (int r = 0; r != kSize; ++r) {
+          if (r == rank || m[r][c] == 0) { continue; }
+          auto factor = m[r][c];
+          for (int j = 0; j != kSize; ++j) {
+            m[r][j] -= factor * m[rank][j];
+          }
+        }
+        pivot_of_column[c] = rank++;
+      }
+      if (rank == kSize) {
+        throw std::invalid_argument("The Jacobi is not diagonalizable.");
+      }
+      // Each free column gives one eigenvector:
+      for (int free = 0; free != kSize && k != kSize; ++free) {
+        if (pivot_of_column[free] >= 0) { continue; }
+        for (int c = 0; c != kSize; ++c) {
+          auto p = pivot_of_column[c];
+          eigen_matrix_r_[c][k] = c == free ? 1 : (p < 0 ? 0 : -m[p][free]);
+        }
+        eigen_values_[k++] = lambda;
+      }
+    }
+  }
+  // L = inv(R) by Gauss-Jordan elimination with partial pivoting:
+  void GetInverseEigenVectors() {
+    auto r = eigen_matrix_r_;
+    auto& l = eigen_matrix_l_;
+    for (int i = 0; i != kSize; ++i) {
+      for (int j = 0; j != kSize; ++j) { l[i][j] = (i == j); }
+    }
+    for (int c = 0; c != kSize; ++c) {
+      int p = c;
+      for (int i = c + 1; i != kSize; ++i) {
+        if (std::abs(r[i][c]) > std::abs(r[p][c])) { p = i; }
+      }
+      std::swap(r[p], r[c]);
+      std::swap(l[p], l[c]);
+      auto pivot = r[c][c];
+      assert(pivot != 0);
+      for (int j = 0; j != kSize; ++j) {
+        r[c][j] /= pivot;
+        l[c][j] /= pivot;
+      }
+      for (int i = 0; i != kSize; ++i) {
+        if (i == c) { continue; }
+        auto factor = r[i][c];
+        for (int j = 0; j != kSize; ++j) {
+          r[i][j] -= factor * r[c][j];
+          l[i][j] -= factor * l[c][j];
+        }
+      }
+    }
+  }
+  Jacobi a_const_;
+  Matrix a_positive_;
+  Matrix a_negative_;
+  Column eigen_values_;
+  Matrix eigen_matrix_r_;
+  Matrix eigen_matrix_l_;
+};
+
+}  // namespace linear
+}  // namespace riemann
+}  // namespace mini
+
+#endif  // MINI_RIEMANN_LINEAR_SYSTEM_HPP_
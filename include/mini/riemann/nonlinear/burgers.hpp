@@ -3,6 +3,7 @@
 #ifndef MINI_RIEMANN_NONLINEAR_BURGERS_HPP_
 #define MINI_RIEMANN_NONLINEAR_BURGERS_HPP_
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 
@@ -23,6 +24,7 @@ class Burgers {
   using State = double;
   using Flux = double;
   using Coefficient = algebra::Column<Jacobi, kDim>;
+  static constexpr bool IsLinear() { return false; }
   // Constructor:
   Burgers() : k_(1) {}
   explicit Burgers(double k) : k_(k) {}
@@ -47,6 +49,10 @@ class Burgers {
   Flux GetFlux(State const& state) const {
     return state * state * k_ / 2;
   }
+  // Get the largest wave speed
+  Scalar GetMaximumSpeed(State const& left, State const& right) const {
+    return std::max(std::abs(k_ * left), std::abs(k_ * right));
+  }
 
  private:
   Jacobi k_;
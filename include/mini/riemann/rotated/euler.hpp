@@ -3,6 +3,8 @@
 #ifndef MINI_RIEMANN_ROTATED_EULER_HPP_
 #define MINI_RIEMANN_ROTATED_EULER_HPP_
 
+#include <algorithm>
+#include <cmath>
 #include <initializer_list>
 
 #include "mini/algebra/column.hpp"
@@ -24,6 +26,7 @@ class Euler {
   using Primitive = typename Base::Primitive;
   using State = Conservative;
   using Flux = typename Base::Flux;
+  static constexpr bool IsLinear() { return false; }
   void Rotate(Vector const& normal) { normal_ = normal; }
   void Rotate(Scalar const& n_1, Scalar const& n_2) {
     normal_[0] = n_1;
@@ -39,6 +42,16 @@ class Euler {
     NormalToGlobal(&(flux.momentum));
     return flux;
   }
+  // The largest wave speed across this wall, which bounds the time step:
+  Scalar GetMaximumSpeed(Conservative const& left,
+                         Conservative const& right) const {
+    auto get_speed = [&](Conservative const& conservative) {
+      auto primitive = Gas::ConservativeToPrimitive(conservative);
+      auto u_n = primitive.momentum.Dot(normal_);
+      return std::abs(u_n) + Gas::GetSpeedOfSound(primitive);
+    };
+    return std::max(get_speed(left), get_speed(right));
+  }
   Flux GetFluxOnSolidWall(Conservative const& conservative) {
     auto primitive = Gas::ConservativeToPrimitive(conservative);
     auto flux = Flux();
@@ -53,6 +66,25 @@ class Euler {
     NormalToGlobal(&(flux.momentum));
     return flux;
   }
+  // Ghost states, which make boundary walls look like interior ones:
+  Conservative GetStateBehindFreeWall(Conservative const& inner) const {
+    return inner;
+  }
+  Conservative GetStateBehindSolidWall(Conservative const& inner) const {
+    // Mirror the momentum about the wall:
+    auto ghost = inner;
+    auto m_n = inner.momentum.Dot(normal_);
+    ghost.momentum[0] -= 2 * m_n * normal_[0];
+    ghost.momentum[1] -= 2 * m_n * normal_[1];
+    return ghost;
+  }
+  // Admissible states have non-negative density and pressure:
+  static bool IsAdmissible(Conservative const& state) {
+    if (!(state.mass >= 0)) { return false; }
+    if (state.mass == 0) { return state.energy >= 0; }  // vacuum
+    auto kinetic = 0.5 * state.momentum.Dot(state.momentum) / state.mass;
+    return state.energy - kinetic >= 0;
+  }
   void GlobalToNormal(Vector* v) {
     auto& n = normal_;
     /* Calculate the normal component: */
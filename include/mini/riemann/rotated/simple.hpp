@@ -2,6 +2,15 @@
 #ifndef MINI_RIEMANN_ROTATED_SIMPLE_HPP_
 #define MINI_RIEMANN_ROTATED_SIMPLE_HPP_
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 #include "mini/algebra/column.hpp"
 
 namespace mini {
@@ -11,6 +20,7 @@ namespace rotated {
 template <class UnrotatedSimple>
 class Simple {
   using Base = UnrotatedSimple;
+  using Key = std::pair<long, long>;  // NOLINT
 
  public:
   using Scalar = typename Base::Scalar;
@@ -19,33 +29,163 @@ class Simple {
   using Flux = typename Base::Flux;
   using Jacobi = typename Base::Jacobi;
   using Coefficient = algebra::Column<Jacobi, 2>;
+  static constexpr bool IsLinear() { return Base::IsLinear(); }
+  // Constructors:
+  Simple() = default;
+  Simple(Simple const& that) : table_(that.table_), index_(that.index_) {
+    Acquire();
+  }
+  Simple& operator=(Simple const& that) {
+    if (this != &that) {
+      Release();
+      table_ = that.table_;
+      index_ = that.index_;
+      Acquire();
+    }
+    return *this;
+  }
+  ~Simple() { Release(); }
   void Rotate(Vector const& normal) {
     Rotate(normal[0], normal[1]);
   }
   void Rotate(Scalar const& n_1, Scalar const& n_2) {
-    auto a_normal = global_coefficient[0] * n_1;
-    a_normal += global_coefficient[1] * n_2;
-    unrotated_simple_ = UnrotatedSimple(a_normal);
+    Release();
+    if (current_table_ < 0 ||
+        !tables_[current_table_].Match(global_coefficient)) {
+      SwitchTable();
+    }
+    // Walls sharing a normal share one (decomposed) unrotated solver:
+    auto& table = tables_[current_table_];
+    auto key = Key{std::lround(n_1 * kResolution),
+                   std::lround(n_2 * kResolution)};
+    auto iter = table.normal_to_index.find(key);
+    if (iter != table.normal_to_index.end()) {
+      index_ = iter->second;
+    } else {
+      auto a_normal = table.coefficient[0] * n_1;
+      a_normal += table.coefficient[1] * n_2;
+      index_ = table.simples.size();
+      table.simples.emplace_back(a_normal);
+      table.normal_to_index.emplace(key, index_);
+    }
+    table_ = current_table_;
+    Acquire();
   }
   Flux GetFluxOnTimeAxis(State const& left, State const& right) {
-    auto flux = unrotated_simple_.GetFluxOnTimeAxis(left, right);
+    auto flux = GetUnrotatedSimple().GetFluxOnTimeAxis(left, right);
     return flux;
   }
+  // The largest wave speed across this wall, which bounds the time step:
+  Scalar GetMaximumSpeed(State const& left, State const& right) const {
+    return GetUnrotatedSimple().GetMaximumSpeed(left, right);
+  }
   Flux GetFluxOnSolidWall(State const& state) {
     return {};
   }
   Flux GetFluxOnFreeWall(State const& state) {
-    return unrotated_simple_.GetFlux(state);
+    return GetUnrotatedSimple().GetFlux(state);
+  }
+  // Ghost states, which make boundary walls look like interior ones:
+  State GetStateBehindFreeWall(State const& inner) const {
+    return inner;
+  }
+  State GetStateBehindSolidWall(State const& inner) const {
+    // Only for bounding wave speeds, since the upwind flux against it is
+    // |A| * inner, which leaks; solid walls take GetFluxOnSolidWall():
+    return inner * -1.0;
+  }
+  // Every finite state is admissible:
+  static constexpr bool IsAdmissible(State const& state) { return true; }
+  // Solvers are shared by walls rotated under the same `global_coefficient`,
+  // in one table per coefficient.  Each wall holds the id of its table and an
+  // index in it.  A table is reused by later walls of the same coefficient,
+  // and freed once no wall uses it, so models of different coefficients can
+  // coexist in one process:
+  static int CountUnrotatedSimples() {
+    return current_table_ < 0 ? 0 : tables_[current_table_].simples.size();
+  }
+  static int CountTables() {
+    int n = 0;
+    for (auto& table : tables_) { n += table.IsAlive(); }
+    return n;
+  }
+  // Detach the current table, which is freed if no wall uses it:
+  static void ClearUnrotatedSimples() {
+    auto i_table = current_table_;
+    current_table_ = -1;
+    FreeIfUnused(i_table);
   }
   static Coefficient global_coefficient;
 
  private:
-  UnrotatedSimple unrotated_simple_;
+  static constexpr double kResolution = 1e+10;
+  static_assert(std::is_trivially_copyable_v<Coefficient>);
+  struct Table {
+    bool Match(Coefficient const& that) const {
+      return std::memcmp(&coefficient, &that, sizeof(Coefficient)) == 0;
+    }
+    bool IsAlive() const { return n_walls > 0 || !simples.empty(); }
+    Coefficient coefficient;
+    std::vector<UnrotatedSimple> simples;
+    std::map<Key, int> normal_to_index;
+    int n_walls{0};
+  };
+  // Make the table of `global_coefficient` current, by reusing a live one
+  // or by filling the first free slot:
+  static void SwitchTable() {
+    auto i_old = current_table_;
+    current_table_ = -1;
+    FreeIfUnused(i_old);
+    int n = tables_.size(), i_free = n;
+    for (int i = 0; i != n; ++i) {
+      if (!tables_[i].IsAlive()) {
+        i_free = std::min(i_free, i);
+      } else if (tables_[i].Match(global_coefficient)) {
+        current_table_ = i;
+        return;
+      }
+    }
+    if (i_free == n) { tables_.emplace_back(); }
+    tables_[i_free].coefficient = global_coefficient;
+    current_table_ = i_free;
+  }
+  static void FreeIfUnused(int i_table) {
+    if (i_table >= 0 && i_table != current_table_ &&
+        tables_[i_table].n_walls == 0) {
+      tables_[i_table] = Table();
+    }
+  }
+  void Acquire() const {
+    if (table_ >= 0) { ++tables_[table_].n_walls; }
+  }
+  void Release() {
+    if (table_ >= 0) {
+      --tables_[table_].n_walls;
+      FreeIfUnused(table_);
+    }
+    table_ = index_ = -1;
+  }
+  UnrotatedSimple const& GetUnrotatedSimple() const {
+    assert(0 <= table_ && table_ < static_cast<int>(tables_.size()));
+    auto& simples = tables_[table_].simples;
+    assert(0 <= index_ && index_ < static_cast<int>(simples.size()));
+    return simples[index_];
+  }
+  static std::vector<Table> tables_;
+  static int current_table_;
+  int table_{-1}, index_{-1};
 };
 template <class UnrotatedSimple>
 typename Simple<UnrotatedSimple>::Coefficient
 Simple<UnrotatedSimple>::global_coefficient;
 
+template <class UnrotatedSimple>
+std::vector<typename Simple<UnrotatedSimple>::Table>
+Simple<UnrotatedSimple>::tables_;
+
+template <class UnrotatedSimple>
+int Simple<UnrotatedSimple>::current_table_{-1};
+
 }  // namespace rotated
 }  // namespace riemann
 }  // namespace mini
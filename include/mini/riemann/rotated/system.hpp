@@ -0,0 +1,19 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+#ifndef MINI_RIEMANN_ROTATED_SYSTEM_HPP_
+#define MINI_RIEMANN_ROTATED_SYSTEM_HPP_
+
+#include "mini/riemann/rotated/simple.hpp"
+#include "mini/riemann/linear/system.hpp"
+
+namespace mini {
+namespace riemann {
+namespace rotated {
+
+template <int kSize>
+using System = Simple<linear::System<kSize>>;
+
+}  // namespace rotated
+}  // namespace riemann
+}  // namespace mini
+
+#endif  // MINI_RIEMANN_ROTATED_SYSTEM_HPP_
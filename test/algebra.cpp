@@ -1,8 +1,16 @@
 // Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <cmath>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "mini/algebra/column.hpp"
+#include "mini/algebra/gmres.hpp"
+#include "mini/algebra/lu.hpp"
 #include "mini/algebra/matrix.hpp"
+#include "mini/algebra/row.hpp"
+#include "mini/algebra/sparse.hpp"
 
 namespace mini {
 namespace algebra {
@@ -42,6 +50,22 @@ TEST_F(ColumnTest, TestScalarMultiplication) {
   EXPECT_EQ(u * 0, v);
   EXPECT_EQ(0 * u, v);
 }
+TEST_F(ColumnTest, TestChainedExpression) {
+  auto u = Vector{1, 2, 3};
+  auto v = Vector{4, 5, 6};
+  Vector w = u * 2 + v - u / 1;
+  EXPECT_EQ(w, (Vector{5, 7, 9}));
+  w = 3 * (w - v) + u;
+  EXPECT_EQ(w, (Vector{4, 8, 12}));
+  w += u - v;
+  EXPECT_EQ(w, (Vector{1, 5, 9}));
+  w -= (u + v) * 0;
+  EXPECT_EQ(w, (Vector{1, 5, 9}));
+}
+TEST_F(ColumnTest, TestPartialInitialization) {
+  auto u = Vector{1};
+  EXPECT_EQ(u, (Vector{1, 0, 0}));
+}
 TEST_F(ColumnTest, TestDotProduct) {
   auto u = Vector{0, 1, 2};
   auto v = Vector{0, 0, 0};
@@ -49,6 +73,12 @@ TEST_F(ColumnTest, TestDotProduct) {
   EXPECT_EQ(u.Dot(v), 0);
   EXPECT_EQ(v.Dot(v), 0);
   EXPECT_EQ(v.Dot(u), 0);
+  // Expressions are taken without being evaluated into temporaries:
+  auto w = Vector{1, 1, 1};
+  EXPECT_EQ(u.Dot(u + w), 8);
+  EXPECT_EQ((u - w) * (u * 2), 4);
+  EXPECT_EQ(w * (u + w), 6);
+  EXPECT_EQ((u + w) * w, 6);
 }
 
 class MatrixTest : public ::testing::Test {
@@ -77,6 +107,16 @@ TEST_F(MatrixTest, TestMatrixProduct) {
   auto p = m * v;
   EXPECT_EQ(p[0], m[0][0]*v[0] + m[0][1]*v[1]);
   EXPECT_EQ(p[1], m[1][0]*v[0] + m[1][1]*v[1]);
+  auto n = algebra::Matrix<int, 2, 3>{{1, 2, 3}, {4, 5, 6}};
+  auto q = n * algebra::Column<int, 3>{1, 1, 1};
+  EXPECT_EQ(q, (Column{6, 15}));
+}
+TEST_F(MatrixTest, TestMatrixMatrixProduct) {
+  auto m = Matrix{{1, 2}, {3, 4}};
+  auto n = algebra::Matrix<int, 2, 3>{{1, 0, 1}, {0, 1, 1}};
+  auto p = m * n;
+  EXPECT_EQ(p[0], (algebra::Row<int, 3>{1, 2, 3}));
+  EXPECT_EQ(p[1], (algebra::Row<int, 3>{3, 4, 7}));
 }
 TEST_F(MatrixTest, TestScalarMultiplication) {
   auto m = Matrix{{1, 2}, {3, 4}};
@@ -87,6 +127,154 @@ TEST_F(MatrixTest, TestScalarMultiplication) {
   EXPECT_EQ(p[1][1], 8);
 }
 
+class SparseTest : public ::testing::Test {
+ protected:
+  using Sparse = Sparse<double, 2>;
+  using Block = Sparse::Block;
+  using Column = Sparse::Column;
+};
+TEST_F(SparseTest, TestMultiply) {
+  // A = [[B, 0, B], [0, 2B, 0], [B, 0, 0]], where B = [[1, 2], [3, 4]]
+  auto b = Block{{1, 2}, {3, 4}};
+  auto a = Sparse(3);
+  a.Emplace(0, 2, b);
+  a.Emplace(0, 0, b);
+  a.Emplace(1, 1, b);
+  a.Emplace(1, 1, b);
+  a.Emplace(2, 0, b);
+  a.Compress();
+  EXPECT_EQ(a.CountRows(), 3);
+  EXPECT_EQ(a.CountBlocks(), 4);
+  auto x = std::vector<Column>{{1, 0}, {0, 1}, {1, 1}};
+  auto y = std::vector<Column>(3);
+  a.Multiply(x, &y);
+  EXPECT_EQ(y[0], (Column{4, 10}));
+  EXPECT_EQ(y[1], (Column{4, 8}));
+  EXPECT_EQ(y[2], (Column{1, 3}));
+  auto z = std::vector<Column>(3);
+  a.Multiply(x, &z, 2/* threads */);
+  EXPECT_EQ(y, z);
+  EXPECT_EQ(a.Find(0, 2), 1);
+  EXPECT_EQ(a.Find(0, 1), -1);
+  EXPECT_EQ(a.GetBlock(a.Find(1, 1)), b * 2.0);
+  a.SetZero();
+  a.Multiply(x, &z);
+  EXPECT_EQ(z, std::vector<Column>(3, Column{0, 0}));
+}
+TEST_F(SparseTest, TestThreadedMultiply) {
+  // Large enough to be split over threads:
+  int n = 1 << 17;
+  auto a = Sparse(n);
+  for (int i = 0; i != n; ++i) {
+    for (int j : {i - 1, i, i + 1}) {
+      if (0 <= j && j < n) {
+        auto block = Block{{1, static_cast<double>(i)},
+                           {static_cast<double>(j), 1}};
+        a.Emplace(i, j, block);
+      }
+    }
+  }
+  a.Compress();
+  auto x = std::vector<Column>(n);
+  for (int i = 0; i != n; ++i) {
+    x[i] = Column{1.0 / (i + 1), static_cast<double>(i % 7)};
+  }
+  auto y = std::vector<Column>(n), z = std::vector<Column>(n);
+  a.Multiply(x, &y);
+  a.Multiply(x, &z, 4/* threads */);
+  EXPECT_EQ(y, z);
+}
+TEST_F(SparseTest, TestIlu) {
+  // ILU(0) of a block tridiagonal matrix is exact:
+  int n = 6;
+  auto a = Sparse(n);
+  for (int i = 0; i != n; ++i) {
+    a.Emplace(i, i, Block{{4, 1}, {-1, 5}});
+    if (i) { a.Emplace(i, i - 1, Block{{-1, 0.5}, {0, -2}}); }
+    if (i + 1 != n) { a.Emplace(i, i + 1, Block{{1, -1}, {0.5, 1}}); }
+  }
+  a.Compress();
+  auto x = std::vector<Column>(n);
+  for (int i = 0; i != n; ++i) { x[i] = Column{1.0 * i, 2.0 - i}; }
+  auto b = std::vector<Column>(n);
+  a.Multiply(x, &b);
+  a.FactorIlu();
+  a.Solve(b.data(), b.data());
+  for (int i = 0; i != n; ++i) {
+    EXPECT_NEAR(b[i][0], x[i][0], 1e-14);
+    EXPECT_NEAR(b[i][1], x[i][1], 1e-14);
+  }
+}
+
+
+class LuTest : public ::testing::Test {
+ protected:
+  using Lu = Lu<double, 3>;
+  using Matrix = Lu::Matrix;
+  using Column = Lu::Column;
+};
+TEST_F(LuTest, TestSolve) {
+  // The zero on the diagonal requires pivoting:
+  auto a = Matrix{{0, 2, 1}, {1, 1, 1}, {2, 1, 3}};
+  auto x = Column{1, -2, 3};
+  auto b = a * x;
+  auto y = Lu(a).Solve(b);
+  for (int i = 0; i != 3; ++i) {
+    EXPECT_DOUBLE_EQ(y[i], x[i]);
+  }
+}
+TEST_F(LuTest, TestInverse) {
+  auto a = Matrix{{0, 2, 1}, {1, 1, 1}, {2, 1, 3}};
+  auto identity = a * Lu(a).Inverse();
+  for (int r = 0; r != 3; ++r) {
+    for (int c = 0; c != 3; ++c) {
+      EXPECT_NEAR(identity[r][c], r == c, 1e-15);
+    }
+  }
+}
+
+class GmresTest : public ::testing::Test {
+ protected:
+  using Gmres = Gmres<double>;
+  using Vector = Gmres::Vector;
+};
+TEST_F(GmresTest, TestSolve) {
+  // A tridiagonal, non-symmetric matrix:
+  int n = 50;
+  auto multiply = [n](Vector const& v, Vector* y) {
+    for (int i = 0; i != n; ++i) {
+      (*y)[i] = 4 * v[i];
+      if (i) { (*y)[i] -= 2 * v[i - 1]; }
+      if (i + 1 != n) { (*y)[i] -= v[i + 1]; }
+    }
+  };
+  auto x = Vector(n);
+  for (int i = 0; i != n; ++i) { x[i] = std::sin(i); }
+  auto b = Vector(n);
+  multiply(x, &b);
+  auto identity = [](Vector const& v, Vector* y) { *y = v; };
+  auto jacobi = [](Vector const& v, Vector* y) {
+    for (int i = 0; i != v.size(); ++i) { (*y)[i] = v[i] / 4; }
+  };
+  for (auto n_restart : {5, 50}) {
+    auto gmres = Gmres(n_restart, 200, 1e-10);
+    auto y = Vector(n);
+    EXPECT_TRUE(gmres.Solve(multiply, identity, b, &y));
+    EXPECT_LE(gmres.GetResidual(), 1e-10);
+    for (int i = 0; i != n; ++i) { EXPECT_NEAR(y[i], x[i], 1e-8); }
+    auto n_iterations = gmres.CountIterations();
+    y.assign(n, 0.0);
+    EXPECT_TRUE(gmres.Solve(multiply, jacobi, b, &y));
+    EXPECT_LE(gmres.CountIterations(), n_iterations);
+    for (int i = 0; i != n; ++i) { EXPECT_NEAR(y[i], x[i], 1e-8); }
+  }
+  // Fail to converge in too few iterations:
+  auto gmres = Gmres(2, 4, 1e-10);
+  auto y = Vector(n);
+  EXPECT_FALSE(gmres.Solve(multiply, identity, b, &y));
+  EXPECT_EQ(gmres.CountIterations(), 4);
+}
+
 }  // namespace algebra
 }  // namespace mini
 
@@ -0,0 +1,132 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "mini/mesh/cache.hpp"
+#include "mini/mesh/dim2.hpp"
+#include "mini/mesh/gmsh.hpp"
+#include "mini/data/path.hpp"  // defines TEST_DATA_DIR
+
+namespace mini {
+namespace mesh {
+
+class CacheTest : public ::testing::Test {
+ protected:
+  using Mesh = Mesh<double>;
+  using Cell = Mesh::Cell;
+  using Wall = Mesh::Wall;
+  using Cache = Cache<Mesh>;
+  const std::string test_data_dir_{TEST_DATA_DIR};
+  const std::string cache_name_{"cache_test.mesh"};
+  void TearDown() override { std::remove(cache_name_.c_str()); }
+};
+TEST_F(CacheTest, Hash) {
+  auto v2 = Cache::Hash(test_data_dir_ + "tiny_v2_ascii.msh");
+  auto v4 = Cache::Hash(test_data_dir_ + "tiny_v4_ascii.msh");
+  EXPECT_NE(v2, v4);
+  EXPECT_EQ(v2, Cache::Hash(test_data_dir_ + "tiny_v2_ascii.msh"));
+  EXPECT_EQ(Cache::Hash(test_data_dir_ + "absent.msh"), 0);
+  EXPECT_EQ(Cache::GetFileName(0x2a), "000000000000002a.mesh");
+}
+TEST_F(CacheTest, WriteAndRead) {
+  auto source = test_data_dir_ + "tiny_v4_binary.msh";
+  auto key = Cache::Hash(source);
+  auto reader = GmshReader<Mesh>();
+  reader.ReadFromFile(source);
+  auto tag_to_name = std::map<int, std::string>();
+  for (auto& pair : reader.GetPhysicalNames()) {
+    if (pair.first.first == 1) {
+      tag_to_name.emplace(pair.first.second, pair.second);
+    }
+  }
+  auto& wall_tags = reader.GetWallTags();
+  auto mesh = reader.GetMesh();
+  EXPECT_TRUE(Cache::WriteToFile(cache_name_, key, *mesh, wall_tags,
+                                 tag_to_name));
+  auto cache = Cache();
+  EXPECT_FALSE(cache.ReadFromFile(cache_name_, key + 1));  // stale
+  EXPECT_FALSE(cache.ReadFromFile("absent.mesh", key));
+  ASSERT_TRUE(cache.ReadFromFile(cache_name_, key));
+  EXPECT_EQ(cache.GetBoundaryNames(), tag_to_name);
+  auto& cached_tags = cache.GetWallTags();
+  EXPECT_EQ(cached_tags.size(), wall_tags.size());
+  auto cached = cache.GetMesh();
+  ASSERT_EQ(cached->CountNodes(), mesh->CountNodes());
+  ASSERT_EQ(cached->CountWalls(), mesh->CountWalls());
+  ASSERT_EQ(cached->CountCells(), mesh->CountCells());
+  // Walls are in the same order, with the same nodes, sides and tags:
+  auto walls = std::vector<Wall const*>();
+  mesh->ForEachWall([&](Wall const& wall) { walls.emplace_back(&wall); });
+  int i = 0;
+  cached->ForEachWall([&](Wall const& wall) {
+    auto& that = *walls[i++];
+    EXPECT_EQ(wall.I(), that.I());
+    EXPECT_EQ(wall.Head()->I(), that.Head()->I());
+    EXPECT_EQ(wall.Tail()->I(), that.Tail()->I());
+    EXPECT_EQ(wall.Center(), that.Center());
+    auto get_id = [](Cell const* cell) { return cell ? cell->I() : -1; };
+    EXPECT_EQ(get_id(wall.GetPositiveSide()), get_id(that.GetPositiveSide()));
+    EXPECT_EQ(get_id(wall.GetNegativeSide()), get_id(that.GetNegativeSide()));
+    auto iter = wall_tags.find(&that);
+    if (iter == wall_tags.end()) {
+      EXPECT_EQ(cached_tags.count(&wall), 0);
+    } else {
+      EXPECT_EQ(cached_tags.at(&wall), iter->second);
+    }
+  });
+  // Cells are in the same order, with the same vertices:
+  auto cells = std::vector<Cell const*>();
+  mesh->ForEachCell([&](Cell const& cell) { cells.emplace_back(&cell); });
+  i = 0;
+  cached->ForEachCell([&](Cell const& cell) {
+    auto& that = *cells[i++];
+    EXPECT_EQ(cell.I(), that.I());
+    ASSERT_EQ(cell.CountVertices(), that.CountVertices());
+    for (int k = 0; k != cell.CountVertices(); ++k) {
+      EXPECT_EQ(cell.GetNode(k)->I(), that.GetNode(k)->I());
+    }
+    EXPECT_EQ(cell.Measure(), that.Measure());
+  });
+}
+TEST_F(CacheTest, Corrupted) {
+  auto source = test_data_dir_ + "tiny_v4_binary.msh";
+  auto key = Cache::Hash(source);
+  auto reader = GmshReader<Mesh>();
+  reader.ReadFromFile(source);
+  auto tag_to_name = std::map<int, std::string>{{1, "inlet"}};
+  ASSERT_TRUE(Cache::WriteToFile(cache_name_, key, *reader.GetMesh(),
+                                 reader.GetWallTags(), tag_to_name));
+  auto size = static_cast<std::streamoff>(
+      std::ifstream(cache_name_, std::ios::binary | std::ios::ate).tellg());
+  // Flip one byte in the records, e.g. a node id or the length of a name:
+  for (auto offset : {size / 2, size - 8}) {
+    auto file = std::fstream(cache_name_,
+                             std::ios::binary | std::ios::in | std::ios::out);
+    file.seekg(offset);
+    auto byte = static_cast<char>(file.get());
+    file.seekp(offset);
+    file.put(static_cast<char>(byte ^ 0x10));
+    file.close();
+    auto cache = Cache();
+    EXPECT_FALSE(cache.ReadFromFile(cache_name_, key));
+    file.open(cache_name_, std::ios::binary | std::ios::in | std::ios::out);
+    file.seekp(offset);
+    file.put(byte);
+    file.close();
+    EXPECT_TRUE(cache.ReadFromFile(cache_name_, key));
+  }
+}
+
+}  // namespace mesh
+}  // namespace mini
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
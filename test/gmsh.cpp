@@ -0,0 +1,82 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+#include "mini/mesh/dim2.hpp"
+#include "mini/mesh/gmsh.hpp"
+#include "mini/data/path.hpp"  // defines TEST_DATA_DIR
+
+namespace mini {
+namespace mesh {
+
+class GmshReaderTest : public ::testing::Test {
+ protected:
+  using Mesh = Mesh<double>;
+  using Cell = Mesh::Cell;
+  using Wall = Mesh::Wall;
+  GmshReader<Mesh> reader;
+  const std::string test_data_dir_{TEST_DATA_DIR};
+};
+TEST_F(GmshReaderTest, GetMesh) {
+  for (auto version : {"v2", "v4"}) {
+    for (auto format : {"ascii", "binary"}) {
+      auto name = std::string("tiny_") + version + "_" + format + ".msh";
+      EXPECT_TRUE(reader.ReadFromFile(test_data_dir_ + name));
+      auto mesh = reader.GetMesh();
+      ASSERT_TRUE(mesh);
+      EXPECT_EQ(mesh->CountNodes(), 6);
+      EXPECT_EQ(mesh->CountWalls(), 8);
+      EXPECT_EQ(mesh->CountCells(), 3);
+      double area = 0.0;
+      mesh->ForEachCell([&area](Cell const& cell) { area += cell.Measure(); });
+      EXPECT_EQ(area, 2.0);
+    }
+  }
+}
+TEST_F(GmshReaderTest, PhysicalGroups) {
+  for (auto version : {"v2", "v4"}) {
+    for (auto format : {"ascii", "binary"}) {
+      auto name = std::string("tiny_") + version + "_" + format + ".msh";
+      reader.ReadFromFile(test_data_dir_ + name);
+      auto& names = reader.GetPhysicalNames();
+      EXPECT_EQ(names.size(), 5);
+      EXPECT_EQ(names.at({1, 1}), "WALL");
+      EXPECT_EQ(names.at({1, 2}), "OPEN");
+      EXPECT_EQ(names.at({2, 5}), "RIGHT");
+      // Boundary walls are in WALL or OPEN, and the middle one in MIDDLE:
+      auto& wall_tags = reader.GetWallTags();
+      EXPECT_EQ(wall_tags.size(), 7);
+      auto mesh = reader.GetMesh();
+      mesh->ForEachWall([&](Wall const& wall) {
+        auto center = wall.Center();
+        if (wall_tags.count(&wall) == 0) {  // the diagonal of the triangles
+          EXPECT_EQ(center.X(), -0.5);
+          EXPECT_EQ(center.Y(), 0.5);
+          return;
+        }
+        auto tag = wall_tags.at(&wall);
+        if (center.X() == 0.0) {
+          EXPECT_EQ(tag, 3);
+        } else if (center.Y() == 0.0 || center.Y() == 1.0) {
+          EXPECT_EQ(tag, 1);
+        } else {
+          EXPECT_EQ(tag, 2);
+        }
+      });
+      auto& cell_tags = reader.GetCellTags();
+      mesh->ForEachCell([&](Cell const& cell) {
+        EXPECT_EQ(cell_tags.at(&cell), cell.Center().X() < 0 ? 4 : 5);
+      });
+    }
+  }
+}
+
+}  // namespace mesh
+}  // namespace mini
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
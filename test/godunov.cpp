@@ -0,0 +1,411 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "mini/mesh/data.hpp"
+#include "mini/mesh/dim2.hpp"
+#include "mini/riemann/rotated/single.hpp"
+#include "mini/model/godunov.hpp"
+#include "mini/data/path.hpp"  // defines TEST_DATA_DIR
+
+namespace mini {
+namespace model {
+
+class GodunovTest : public ::testing::Test {
+ protected:
+  using Riemann = riemann::rotated::Single;
+  using State = Riemann::State;
+  using Flux = Riemann::Flux;
+  using NodeData = mesh::Empty;
+  struct WallData : public mesh::Empty {
+    Flux flux;
+    Riemann riemann;
+  };
+  struct CellData : public mesh::Data<
+      double, 2/* dims */, 1/* scalars */, 0/* vectors */> {
+   public:
+    State state;
+    void Write() {
+      scalars[0] = state;
+    }
+  };
+  using Mesh = mesh::Mesh<double, NodeData, WallData, CellData>;
+  using Cell = Mesh::Cell;
+  using Wall = Mesh::Wall;
+  using Model = Godunov<Mesh, Riemann>;
+  const std::string test_data_dir_{TEST_DATA_DIR};
+  const std::string output_dir_{"godunov_test/"};
+  void SetUp() override {
+    Mesh::Cell::scalar_names.at(0) = "U";
+    Riemann::global_coefficient = {1.0, 0.5};
+    std::system(("mkdir -p " + output_dir_).c_str());
+  }
+  void TearDown() override {
+    std::system(("rm -rf " + output_dir_).c_str());
+  }
+  // A model on [-2, 2] * [-1, 1], whose four sides are all solid, or whose
+  // left and right sides are free (if `free_ends`):
+  static void Build(Model* model, std::string const& mesh_name,
+                    bool free_ends = false) {
+    model->ReadMesh(std::string(TEST_DATA_DIR) + mesh_name);
+    model->SetBoundaryNames({
+      {"left", [](Wall& wall) { return wall.Center().X() == -2.0; }},
+      {"right", [](Wall& wall) { return wall.Center().X() == +2.0; }},
+      {"top", [](Wall& wall) { return wall.Center().Y() == +1.0; }},
+      {"bottom", [](Wall& wall) { return wall.Center().Y() == -1.0; }},
+    });
+    for (auto name : {"left", "right"}) {
+      if (free_ends) {
+        model->SetFreeBoundary(name);
+      } else {
+        model->SetSolidBoundary(name);
+      }
+    }
+    for (auto name : {"top", "bottom"}) {
+      model->SetSolidBoundary(name);
+    }
+    model->SetInitialState([](Cell& cell) {
+      auto x = cell.Center().X(), y = cell.Center().Y();
+      cell.data.state = 1 + std::sin(x) * std::cos(y);
+    });
+  }
+  static double GetMass(Model const& model) {
+    auto mass = 0.0;
+    model.GetMesh().ForEachCell([&](Cell const& cell) {
+      mass += cell.data.state * cell.Measure();
+    });
+    return mass;
+  }
+  // The last step logged by a steady run:
+  int CountSteps(std::string const& model_name) const {
+    auto log = std::ifstream(output_dir_ + model_name + ".residual");
+    auto line = std::string(), last = std::string();
+    while (std::getline(log, line)) { last = line; }
+    return std::stoi(last);
+  }
+  // Run a steady case toward a relative `tolerance`, in which local time
+  // steps are taken if `cfl > 0`:
+  template <class Configure>
+  std::vector<State> RunSteady(std::string const& model_name, double cfl,
+                               Configure&& configure) {
+    auto model = Model(model_name);
+    Riemann::global_coefficient = {1.0, 0.0};
+    Build(&model, "medium.vtk", true/* free_ends */);
+    model.SetTimeSteps(20.0, 2000, 2000);
+    model.SetOutputDir(output_dir_);
+    model.SetSteadyState(1e-8);
+    if (cfl > 0) { model.UseLocalTimeSteps(cfl); }
+    configure(&model);
+    model.Calculate();
+    return GetStates(model);
+  }
+  static std::vector<State> GetStates(Model const& model) {
+    auto states = std::vector<State>();
+    model.GetMesh().ForEachCell([&](Cell const& cell) {
+      states.emplace_back(cell.data.state);
+    });
+    return states;
+  }
+};
+TEST_F(GodunovTest, SolidWallsConserveMass) {
+  auto model = Model("solid");
+  Build(&model, "medium.vtk");
+  auto mass = GetMass(model);
+  model.SetTimeSteps(0.4, 40, 40);
+  model.SetOutputDir(output_dir_);
+  model.Calculate();
+  EXPECT_NEAR(GetMass(model), mass, 1e-12 * mass);
+  // The sparse matrix is assembled from GetFluxOnSolidWall() directly:
+  auto sparse = Model("sparse");
+  Build(&sparse, "medium.vtk");
+  sparse.SetTimeSteps(0.4, 40, 40);
+  sparse.SetOutputDir(output_dir_);
+  sparse.UseSparseMatrix();
+  sparse.Calculate();
+  EXPECT_NEAR(GetMass(sparse), mass, 1e-12 * mass);
+  auto expected = GetStates(sparse), actual = GetStates(model);
+  ASSERT_EQ(actual.size(), expected.size());
+  for (int i = 0; i != actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-12);
+  }
+}
+TEST_F(GodunovTest, SteadyRunsConverge) {
+  auto expected = RunSteady("explicit", 0.0, [](Model*) {});
+  // Converged long before the upper bound of steps:
+  int n_steps = CountSteps("explicit");
+  EXPECT_LT(n_steps, 1000);
+  // Cells beside the left side take their own states as inflow, so they are
+  // frozen, and the others take those states downstream:
+  auto again = RunSteady("again", 0.0, [](Model* model) {
+    model->SetSteadyState(1e-10);
+  });
+  EXPECT_GT(CountSteps("again"), n_steps);
+  for (int i = 0; i != again.size(); ++i) {
+    EXPECT_NEAR(again[i], expected[i], 1e-6);
+  }
+}
+TEST_F(GodunovTest, LocalTimeSteps) {
+  auto expected = RunSteady("global", 0.0, [](Model*) {});
+  auto actual = RunSteady("local", 0.9, [](Model*) {});
+  EXPECT_LT(CountSteps("local"), CountSteps("global"));
+  for (int i = 0; i != actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-6);
+  }
+}
+TEST_F(GodunovTest, ImplicitSteps) {
+  auto expected = RunSteady("explicit", 0.9, [](Model*) {});
+  auto actual = RunSteady("jacobi", 100, [](Model* model) {
+    model->UseImplicitSteps(1);
+  });
+  EXPECT_LT(CountSteps("jacobi"), 20);
+  for (int i = 0; i != actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-6);
+  }
+  actual = RunSteady("ilu", 100, [](Model* model) {
+    model->UseImplicitSteps(1);
+    model->UseIluPreconditioner();
+  });
+  EXPECT_LT(CountSteps("ilu"), 20);
+  for (int i = 0; i != actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-6);
+  }
+}
+TEST_F(GodunovTest, LuSgsSteps) {
+  auto expected = RunSteady("explicit", 0.9, [](Model*) {});
+  auto actual = RunSteady("lu_sgs", 1000, [](Model* model) {
+    model->UseLuSgsSteps(1.5);
+  });
+  EXPECT_LT(CountSteps("lu_sgs"), CountSteps("explicit"));
+  for (int i = 0; i != actual.size(); ++i) {
+    EXPECT_NEAR(actual[i], expected[i], 1e-6);
+  }
+}
+TEST_F(GodunovTest, SubdomainsMatchSerialSteps) {
+  for (int n_steps : {7, 8}) {
+    auto run = [&](int n_subdomains) {
+      auto model = Model("subdomains");
+      Build(&model, "medium.vtk");
+      model.SetTimeSteps(0.01 * n_steps, n_steps, 3);
+      model.SetOutputDir(output_dir_);
+      if (n_subdomains) { model.UseSubdomains(n_subdomains); }
+      model.Calculate();
+      return GetStates(model);
+    };
+    auto expected = run(0);
+    for (int n_subdomains : {1, 2, 4}) {
+      EXPECT_EQ(run(n_subdomains), expected);
+    }
+  }
+}
+TEST_F(GodunovTest, EnsembleMatchesSeparateRuns) {
+  constexpr int kMembers = 3;
+  auto initial_state = [](Cell const& cell, int member) {
+    auto x = cell.Center().X(), y = cell.Center().Y();
+    return member + std::sin(x * (member + 1)) * std::cos(y);
+  };
+  auto ensemble = Model("ensemble");
+  Build(&ensemble, "medium.vtk", true/* free_ends */);
+  ensemble.UseEnsemble(kMembers);
+  ensemble.SetInitialStates(initial_state);
+  ensemble.SetTimeSteps(0.4, 40, 40);
+  ensemble.SetOutputDir(output_dir_);
+  ensemble.Calculate();
+  for (int m = 0; m != kMembers; ++m) {
+    auto model = Model("member");
+    Build(&model, "medium.vtk", true/* free_ends */);
+    model.SetInitialState([&](Cell& cell) {
+      cell.data.state = initial_state(cell, m);
+    });
+    model.SetTimeSteps(0.4, 40, 40);
+    model.SetOutputDir(output_dir_);
+    model.Calculate();
+    auto expected = GetStates(model);
+    auto actual = std::vector<State>();
+    ensemble.GetMesh().ForEachCell([&](Cell const& cell) {
+      actual.emplace_back(ensemble.GetState(cell, m));
+    });
+    EXPECT_EQ(actual, expected);
+  }
+}
+TEST(RollbackTest, RestoreSnapshots) {
+  auto rollback = Rollback<double>(2/* snapshots */, 1/* halving */);
+  auto save = [](double value) {
+    return [value](std::vector<double>* states) { states->assign(3, value); };
+  };
+  EXPECT_FALSE(rollback.Save(10, save(1.0)));
+  EXPECT_FALSE(rollback.Save(20, save(2.0)));
+  EXPECT_FALSE(rollback.Save(30, save(3.0)));  // overwrites that of step 10
+  EXPECT_EQ(rollback.CountSnapshots(), 2);
+  // Restart from the latest snapshot with a halved step size:
+  auto snapshot = rollback.Fail();
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->step, 30);
+  EXPECT_EQ(snapshot->states, std::vector<double>(3, 3.0));
+  EXPECT_EQ(rollback.CountHalvings(), 1);
+  // No more halving, so the latest snapshot is dropped:
+  snapshot = rollback.Fail();
+  ASSERT_NE(snapshot, nullptr);
+  EXPECT_EQ(snapshot->step, 20);
+  EXPECT_EQ(snapshot->states, std::vector<double>(3, 2.0));
+  EXPECT_EQ(rollback.CountSnapshots(), 1);
+  EXPECT_EQ(rollback.Fail(), nullptr);
+}
+TEST(RollbackTest, RestoreStepSize) {
+  auto rollback = Rollback<double>(2/* snapshots */, 2/* halvings */);
+  auto save = [](std::vector<double>* states) { states->assign(1, 0.0); };
+  rollback.Save(0, save);
+  rollback.Fail();
+  rollback.Fail();
+  EXPECT_EQ(rollback.CountHalvings(), 2);
+  // Each whole ring of healthy snapshots takes back one halving:
+  EXPECT_FALSE(rollback.Save(1, save));
+  EXPECT_TRUE(rollback.Save(2, save));
+  EXPECT_EQ(rollback.CountHalvings(), 1);
+  EXPECT_FALSE(rollback.Save(3, save));
+  rollback.Fail();  // which breaks the ring
+  EXPECT_EQ(rollback.CountHalvings(), 2);
+  EXPECT_FALSE(rollback.Save(4, save));
+  EXPECT_TRUE(rollback.Save(5, save));
+  EXPECT_EQ(rollback.CountHalvings(), 1);
+}
+TEST_F(GodunovTest, SnapshotsLeaveStatesAlone) {
+  auto run = [&](bool use_rollback) {
+    auto model = Model(use_rollback ? "rollback" : "plain");
+    Build(&model, "medium.vtk");
+    model.SetTimeSteps(0.4, 40, 40);
+    model.SetOutputDir(output_dir_);
+    if (use_rollback) {
+      model.SetWatchdog(5);
+      model.SetRollback(3);
+    }
+    model.Calculate();
+    return GetStates(model);
+  };
+  EXPECT_EQ(run(true), run(false));
+}
+TEST_F(GodunovTest, ReportBlowup) {
+  auto model = Model("blowup");
+  Build(&model, "medium.vtk");
+  model.SetTimeSteps(2000.0, 1000, 1000);  // far beyond the CFL limit
+  model.SetOutputDir(output_dir_);
+  model.SetWatchdog(10, 2/* reports */);
+  try {
+    model.Calculate();
+    FAIL() << "No `Blowup` is thrown.";
+  } catch (Blowup const& blowup) {
+    // Found by the watchdog before the last step:
+    auto step = blowup.GetStep();
+    EXPECT_EQ(step % 10, 0);
+    EXPECT_LT(step, 1000);
+    auto report = std::istringstream(blowup.what());
+    auto line = std::string();
+    std::getline(report, line);
+    int n_bad = std::stoi(line);
+    EXPECT_GT(n_bad, 2);
+    EXPECT_EQ(line, std::to_string(n_bad) + " unhealthy state(s) at step "
+                    + std::to_string(step) + ":");
+    // Only two cells are reported, each with its three neighbors or walls:
+    int n_cells = 0, n_neighbors = 0;
+    auto last = std::string();
+    while (std::getline(report, line)) {
+      last = line;
+      n_cells += line.rfind("  cell ", 0) == 0;
+      n_neighbors += line.rfind("    neighbor ", 0) == 0;
+      n_neighbors += line.rfind("    boundary wall ", 0) == 0;
+    }
+    EXPECT_EQ(n_cells, 2);
+    EXPECT_EQ(n_neighbors, 6);
+    EXPECT_EQ(last, "  ... and " + std::to_string(n_bad - 2) + " more");
+  }
+}
+TEST_F(GodunovTest, RollBackFromBlowup) {
+  auto model = Model("recovered");
+  Build(&model, "medium.vtk");
+  model.SetTimeSteps(2000.0, 1000, 1000);  // far beyond the CFL limit
+  model.SetOutputDir(output_dir_);
+  model.SetWatchdog(10);
+  model.SetRollback(2, 8/* halvings */);
+  // Halved steps take over, so no `Blowup` is thrown.  Only non-finite
+  // states are caught, so finite but amplified ones may still be saved in
+  // snapshots, and only the finiteness of the result is checked:
+  model.Calculate();
+  for (auto state : GetStates(model)) {
+    EXPECT_TRUE(std::isfinite(state));
+  }
+}
+TEST_F(GodunovTest, RejectConflictingModes) {
+  auto expect_rejected = [&](auto&& configure) {
+    auto model = Model("rejected");
+    Build(&model, "medium.vtk");
+    model.SetTimeSteps(0.1, 10, 10);
+    model.SetOutputDir(output_dir_);
+    configure(&model);
+    EXPECT_THROW(model.Calculate(), std::invalid_argument);
+  };
+  expect_rejected([](Model* model) {
+    model->SetSteadyState(1e-6);
+    model->UseSubdomains(2);
+  });
+  expect_rejected([](Model* model) {
+    model->UseEnsemble(2);
+    model->UseImplicitSteps(1);
+  });
+  expect_rejected([](Model* model) {
+    model->UseEnsemble(2);
+    model->UseLuSgsSteps(1.5);
+  });
+  expect_rejected([](Model* model) {
+    model->UseEnsemble(2);
+    model->UseSparseMatrix();
+  });
+  expect_rejected([](Model* model) {
+    model->UseSparseMatrix();
+    model->UseSubdomains(2);
+  });
+  expect_rejected([](Model* model) {
+    model->UseLocalTimeSteps(0.5);  // without a steady state
+  });
+  expect_rejected([](Model* model) {
+    model->SetSteadyState(1e-6);
+    model->UseLocalTimeSteps(0.5);
+    model->UseSparseMatrix();
+  });
+  expect_rejected([](Model* model) {
+    model->UseImplicitSteps(1);
+    model->UseLuSgsSteps(1.5);
+  });
+  expect_rejected([](Model* model) {
+    model->SetRollback(2);  // without a watchdog
+  });
+  expect_rejected([](Model* model) {
+    model->SetWatchdog(1);
+    model->SetRollback(2);
+    model->UseSubdomains(2);
+  });
+  expect_rejected([](Model* model) {
+    model->SetSteadyState(1e-6);
+    model->UseMultigrid(2);  // without local time steps
+  });
+  expect_rejected([](Model* model) {
+    model->SetSteadyState(1e-6);
+    model->UseLocalTimeSteps(0.5);
+    model->UseMultigrid(2);
+    model->UseLuSgsSteps(1.5);
+  });
+}
+
+}  // namespace model
+}  // namespace mini
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,14 +1,52 @@
 // Copyright 2019 Weicheng Pei and Minghao Yang
 
+#include <cmath>
+#include <memory>
+#include <stdexcept>
 #include <vector>
 
+#include "mini/mesh/arena.hpp"
 #include "mini/mesh/dim2.hpp"
+#include "mini/mesh/partition.hpp"
+#include "mini/mesh/remap.hpp"
+#include "mini/model/boundary.hpp"
 
 #include "gtest/gtest.h"
 
 namespace mini {
 namespace mesh {
 
+class ArenaTest : public ::testing::Test {
+ protected:
+  struct Counted {
+    explicit Counted(int i) : i(i) { ++n_alive; }
+    ~Counted() { --n_alive; }
+    int i;
+    static int n_alive;
+  };
+};
+int ArenaTest::Counted::n_alive = 0;
+TEST_F(ArenaTest, EmplaceAndDestroy) {
+  constexpr int n = 100000;
+  {
+    auto arena = Arena<Counted>();
+    auto pointers = std::vector<Counted*>();
+    for (int i = 0; i != n; ++i) {
+      pointers.emplace_back(arena.Emplace(i));
+    }
+    EXPECT_EQ(arena.size(), n);
+    EXPECT_EQ(Counted::n_alive, n);
+    // Objects never move, and are visited in creation order:
+    int i = 0;
+    arena.ForEach([&](Counted const& object) {
+      EXPECT_EQ(&object, pointers[i]);
+      EXPECT_EQ(object.i, i++);
+    });
+    EXPECT_EQ(i, n);
+  }
+  EXPECT_EQ(Counted::n_alive, 0);
+}
+
 class WallTest : public ::testing::Test {
  protected:
   using Wall = Wall<double>;
@@ -185,6 +223,258 @@ TEST_F(MeshTest, ForEachCell) {
     EXPECT_FALSE(a->IsClockWise(b, c));
   });
 }
+TEST_F(MeshTest, ForEachTriangleAndRectangle) {
+  /*
+     3       2 ----- 5
+           / |       |
+         /   |       |
+       /     |       |
+     0 ----- 1 ----- 4
+  */
+  for (auto i = 0; i != x.size(); ++i) {
+    mesh.EmplaceNode(i, x[i], y[i]);
+  }
+  mesh.EmplaceNode(4, 2.0, 0.0);
+  mesh.EmplaceNode(5, 2.0, 1.0);
+  auto triangle = mesh.EmplaceCell(0, {0, 1, 2});
+  auto rectangle = mesh.EmplaceCell(1, {1, 4, 5, 2});
+  EXPECT_EQ(mesh.CountTriangles(), 1);
+  EXPECT_EQ(mesh.CountRectangles(), 1);
+  // Dispatch through the common part:
+  EXPECT_EQ(triangle->GetKind(), Cell::Kind::kTriangle);
+  EXPECT_EQ(triangle->CountVertices(), 3);
+  EXPECT_DOUBLE_EQ(triangle->Measure(), 0.5);
+  EXPECT_EQ(rectangle->GetKind(), Cell::Kind::kRectangle);
+  EXPECT_EQ(rectangle->CountVertices(), 4);
+  EXPECT_DOUBLE_EQ(rectangle->Measure(), 1.0);
+  EXPECT_EQ(rectangle->I(), 1);
+  // Visit each block with its concrete type:
+  mesh.ForEachTriangle([&](Mesh::Triangle const& cell) {
+    EXPECT_EQ(&cell, triangle);
+    EXPECT_EQ(cell.CountVertices(), 3);
+  });
+  mesh.ForEachRectangle([&](Mesh::Rectangle const& cell) {
+    EXPECT_EQ(&cell, rectangle);
+    EXPECT_EQ(cell.CountVertices(), 4);
+  });
+}
+TEST_F(MeshTest, Partition) {
+  // Emplace a 16-by-16 grid of rectangles:
+  constexpr int n = 16;
+  for (int i = 0; i <= n; ++i) {
+    for (int j = 0; j <= n; ++j) {
+      mesh.EmplaceNode(i * (n + 1) + j, i, j);
+    }
+  }
+  for (int i = 0; i != n; ++i) {
+    for (int j = 0; j != n; ++j) {
+      Node::Id a = i * (n + 1) + j, b = a + n + 1;
+      mesh.EmplaceCell(i * n + j, {a, b, b + 1, a + 1});
+    }
+  }
+  constexpr int n_parts = 4;
+  auto partition = Partition<Mesh>(&mesh, n_parts);
+  EXPECT_EQ(partition.CountParts(), n_parts);
+  // Parts are balanced, and linked by a few walls (16 * 2 at best):
+  int n_cells = 0, n_walls = 0, n_cut_walls = 0;
+  for (int p = 0; p != n_parts; ++p) {
+    auto& cells = partition.GetCells(p);
+    EXPECT_NEAR(cells.size(), n * n / n_parts, n * n / n_parts * 0.03 + 1);
+    for (auto cell : cells) { EXPECT_EQ(partition.GetPart(*cell), p); }
+    n_cells += cells.size();
+    for (auto wall : partition.GetInteriorWalls(p)) {
+      EXPECT_EQ(partition.GetPart(*wall->GetPositiveSide()), p);
+      EXPECT_EQ(partition.GetPart(*wall->GetNegativeSide()), p);
+    }
+    for (auto wall : partition.GetCutWalls(p)) {
+      auto positive = partition.GetPart(*wall->GetPositiveSide());
+      auto negative = partition.GetPart(*wall->GetNegativeSide());
+      EXPECT_NE(positive, negative);
+      EXPECT_TRUE(positive == p || negative == p);
+    }
+    n_walls += partition.GetInteriorWalls(p).size();
+    n_walls += partition.GetBoundaryWalls(p).size();
+    n_cut_walls += partition.GetCutWalls(p).size();
+  }
+  EXPECT_EQ(n_cells, mesh.CountCells());
+  EXPECT_EQ(n_cut_walls, partition.CountCutWalls() * 2);
+  EXPECT_EQ(n_walls + partition.CountCutWalls(), mesh.CountWalls());
+  EXPECT_LE(partition.CountCutWalls(), 16 * 2 * 2);
+}
+TEST_F(MeshTest, MergePeriodicWalls) {
+  // Emplace a 4-by-3 grid of rectangles, whose top nodes carry round-off:
+  constexpr int nx = 4, ny = 3;
+  for (int i = 0; i <= ny; ++i) {
+    for (int j = 0; j <= nx; ++j) {
+      auto x = j * 0.1 + (i == ny ? 1e-14 : 0.0);
+      mesh.EmplaceNode(i * (nx + 1) + j, x, i * 0.1);
+    }
+  }
+  for (int i = 0; i != ny; ++i) {
+    for (int j = 0; j != nx; ++j) {
+      Node::Id a = i * (nx + 1) + j, b = a + nx + 1;
+      mesh.EmplaceCell(i * nx + j, {a, a + 1, b + 1, b});
+    }
+  }
+  auto manager = model::Manager<Mesh>();
+  mesh.ForEachWall([&](Wall& wall) {
+    if (wall.GetPositiveSide() && wall.GetNegativeSide()) {
+      manager.AddInteriorWall(&wall);
+    } else {
+      manager.AddBoundaryWall(&wall);
+    }
+  });
+  manager.SetBoundaryName("bottom", [](Wall& wall) {
+    return wall.Center().Y() < 0.05;
+  });
+  manager.SetBoundaryName("top", [](Wall& wall) {
+    return wall.Center().Y() > ny * 0.1 - 0.05;
+  });
+  auto n_interior_walls = 0;
+  manager.ForEachInteriorWall([&](Wall*) { ++n_interior_walls; });
+  manager.SetBoundaryName("sides", [](Wall& wall) {
+    return wall.Center().X() < 0.01 || wall.Center().X() > nx * 0.1 - 0.01;
+  });
+  manager.SetPeriodicBoundary("bottom", "top");
+  manager.SetFreeBoundary("sides");
+  manager.ClearBoundaryCondition();
+  auto n_merged_walls = -n_interior_walls;
+  manager.ForEachInteriorWall([&](Wall*) { ++n_merged_walls; });
+  EXPECT_EQ(n_merged_walls, nx);
+  // Each bottom cell shares one wall with the top cell in its column:
+  manager.ForEachInteriorWall([&](Wall* wall) {
+    if (wall->Center().Y() < 0.05) {
+      auto positive = wall->GetPositiveSide();
+      auto negative = wall->GetNegativeSide();
+      EXPECT_NEAR(positive->Center().X(), negative->Center().X(), 1e-12);
+      EXPECT_NEAR(std::abs(positive->Center().Y() - negative->Center().Y()),
+                  (ny - 1) * 0.1, 1e-12);
+      auto n_owners = 0;
+      for (auto cell : {positive, negative}) {
+        cell->ForEachWall([&](Wall& that) { n_owners += (&that == wall); });
+      }
+      EXPECT_EQ(n_owners, 2);
+    }
+  });
+}
+TEST_F(MeshTest, RejectSharedPeriodicMatches) {
+  // One row of 4 quadrangles, whose bottom walls are much finer than their
+  // top walls, so the first three bottom walls are all nearest to the same
+  // top wall:
+  auto bottom_x = std::vector<double>{0.0, 0.025, 0.05, 0.075, 1.0};
+  auto top_x = std::vector<double>{0.0, 0.3, 0.55, 0.825, 1.0};
+  for (int j = 0; j != 5; ++j) {
+    mesh.EmplaceNode(j, bottom_x[j], 0.0);
+    mesh.EmplaceNode(j + 5, top_x[j], 1.0);
+  }
+  for (int j = 0; j != 4; ++j) {
+    Node::Id a = j, b = j + 5;
+    mesh.EmplaceCell(j, {a, a + 1, b + 1, b});
+  }
+  auto manager = model::Manager<Mesh>();
+  mesh.ForEachWall([&](Wall& wall) {
+    if (wall.GetPositiveSide() && wall.GetNegativeSide()) {
+      manager.AddInteriorWall(&wall);
+    } else {
+      manager.AddBoundaryWall(&wall);
+    }
+  });
+  manager.SetBoundaryNames({
+    {"bottom", [](Wall& wall) { return wall.Center().Y() == 0.0; }},
+    {"top", [](Wall& wall) { return wall.Center().Y() == 1.0; }},
+    {"sides", [](Wall& wall) {
+      return wall.Center().Y() != 0.0 && wall.Center().Y() != 1.0;
+    }},
+  });
+  manager.SetPeriodicBoundary("bottom", "top");
+  manager.SetFreeBoundary("sides");
+  EXPECT_THROW(manager.ClearBoundaryCondition(), std::invalid_argument);
+}
+TEST_F(MeshTest, ClassifyBoundaryWalls) {
+  for (auto i = 0; i != x.size(); ++i) {
+    mesh.EmplaceNode(i, x[i], y[i]);
+  }
+  mesh.EmplaceCell(0, {0, 1, 2, 3});
+  auto add_boundary_walls = [&](model::Manager<Mesh>* manager) {
+    mesh.ForEachWall([&](Wall& wall) {
+      manager->AddBoundaryWall(&wall, wall.Center().Y() == 0.0 ? 1 : 0);
+    });
+  };
+  auto bottom = [](Wall& wall) { return wall.Center().Y() == 0.0; };
+  auto others = [](Wall& wall) { return wall.Center().Y() != 0.0; };
+  {  // Each wall is claimed once, either by a tag or by a predicate:
+    auto manager = model::Manager<Mesh>();
+    add_boundary_walls(&manager);
+    manager.SetBoundaryTag("bottom", 1);
+    manager.SetBoundaryName("others", others);
+    manager.SetFreeBoundary("bottom");
+    manager.SetSolidBoundary("others");
+    manager.ClearBoundaryCondition();
+    auto n_free = 0, n_solid = 0;
+    manager.ForEachFreeWall([&](Wall* wall) { ++n_free; });
+    manager.ForEachSolidWall([&](Wall* wall) { ++n_solid; });
+    EXPECT_EQ(n_free, 1);
+    EXPECT_EQ(n_solid, 3);
+  }
+  {  // The bottom wall is claimed twice:
+    auto manager = model::Manager<Mesh>();
+    add_boundary_walls(&manager);
+    manager.SetBoundaryTag("tagged", 1);
+    manager.SetBoundaryName("bottom", bottom);
+    manager.SetBoundaryName("others", others);
+    EXPECT_THROW(manager.ClearBoundaryCondition(), std::length_error);
+  }
+  {  // The bottom wall is claimed twice by predicates:
+    auto manager = model::Manager<Mesh>();
+    add_boundary_walls(&manager);
+    manager.SetBoundaryName("bottom", bottom);
+    EXPECT_THROW(manager.SetBoundaryName("all", [](Wall&) { return true; }),
+                 std::length_error);
+  }
+  {  // All predicates are evaluated in one call:
+    auto manager = model::Manager<Mesh>();
+    add_boundary_walls(&manager);
+    manager.SetBoundaryNames({{"bottom", bottom}, {"others", others}});
+    manager.SetFreeBoundary("bottom");
+    manager.SetSolidBoundary("others");
+    manager.ClearBoundaryCondition();
+    auto n_free = 0, n_solid = 0;
+    manager.ForEachFreeWall([&](Wall* wall) { ++n_free; });
+    manager.ForEachSolidWall([&](Wall* wall) { ++n_solid; });
+    EXPECT_EQ(n_free, 1);
+    EXPECT_EQ(n_solid, 3);
+  }
+  {  // The bottom wall is claimed twice in one call:
+    auto manager = model::Manager<Mesh>();
+    add_boundary_walls(&manager);
+    auto all = [](Wall&) { return true; };
+    EXPECT_THROW(manager.SetBoundaryNames({{"bottom", bottom}, {"all", all}}),
+                 std::length_error);
+  }
+  {  // The bottom wall is not claimed:
+    auto manager = model::Manager<Mesh>();
+    add_boundary_walls(&manager);
+    manager.SetBoundaryName("others", others);
+    EXPECT_THROW(manager.ClearBoundaryCondition(), std::length_error);
+  }
+  {  // Predicates are evaluated at once, so their captures may expire:
+    auto manager = model::Manager<Mesh>();
+    add_boundary_walls(&manager);
+    {
+      auto y_bottom = 0.0;
+      manager.SetBoundaryName("bottom", [&y_bottom](Wall& wall) {
+        return wall.Center().Y() == y_bottom;
+      });
+    }
+    manager.SetBoundaryName("others", others);
+    manager.SetFreeBoundary("bottom");
+    manager.SetSolidBoundary("others");
+    manager.ClearBoundaryCondition();
+    auto n_free = 0;
+    manager.ForEachFreeWall([&](Wall* wall) { ++n_free; });
+    EXPECT_EQ(n_free, 1);
+  }
+}
 TEST_F(MeshTest, GetSide) {
   /*
      3 -- [2] -- 2
@@ -230,6 +520,81 @@ TEST_F(MeshTest, GetSide) {
   EXPECT_EQ(walls[3]->GetNegativeSide(), cells[1]);
 }
 
+class RemapTest : public ::testing::Test {
+ protected:
+  using Mesh = Mesh<double>;
+  using Node = Mesh::Node;
+  using Cell = Mesh::Cell;
+  using Remap = Remap<Mesh>;
+  using Polygon = Remap::Polygon;
+  // An n * n grid of squares on [0, 1] * [0, 1], each of which is split into
+  // two triangles if `split`:
+  static std::unique_ptr<Mesh> GetGrid(int n, bool split) {
+    auto mesh = std::make_unique<Mesh>();
+    for (int j = 0; j <= n; ++j) {
+      for (int i = 0; i <= n; ++i) {
+        mesh->EmplaceNode(j * (n + 1) + i, 1.0 * i / n, 1.0 * j / n);
+      }
+    }
+    Cell::Id id = 0;
+    for (int j = 0; j != n; ++j) {
+      for (int i = 0; i != n; ++i) {
+        Node::Id a = j * (n + 1) + i, b = a + 1, c = b + n + 1, d = c - 1;
+        if (split) {
+          mesh->EmplaceCell(id++, {a, b, c});
+          mesh->EmplaceCell(id++, {a, c, d});
+        } else {
+          mesh->EmplaceCell(id++, {a, b, c, d});
+        }
+      }
+    }
+    return mesh;
+  }
+};
+TEST_F(RemapTest, Clip) {
+  auto square = Polygon{{0.0, 0.0}, {1.0, 0.0}, {1.0, 1.0}, {0.0, 1.0}};
+  auto shifted = Polygon{{0.5, 0.5}, {1.5, 0.5}, {1.5, 1.5}, {0.5, 1.5}};
+  EXPECT_DOUBLE_EQ(Remap::GetArea(Remap::Clip(square, shifted)), 0.25);
+  auto triangle = Polygon{{0.0, 0.0}, {1.0, 0.0}, {0.0, 1.0}};
+  EXPECT_DOUBLE_EQ(Remap::GetArea(Remap::Clip(square, triangle)), 0.5);
+  EXPECT_DOUBLE_EQ(Remap::GetArea(Remap::Clip(shifted, triangle)), 0.0);
+}
+TEST_F(RemapTest, GetAverage) {
+  auto coarse = GetGrid(3, false), fine = GetGrid(7, true);
+  auto remap = Remap(*coarse);
+  EXPECT_EQ(remap.CountBuckets(), 9);
+  auto get = [](Cell const& cell) {
+    auto center = cell.Center();
+    return center.X() + 2 * center.Y() * center.Y();
+  };
+  // Constants are kept, and integrals are conserved:
+  auto coarse_integral = 0.0, fine_integral = 0.0;
+  coarse->ForEachCell([&](Cell const& cell) {
+    coarse_integral += get(cell) * cell.Measure();
+  });
+  fine->ForEachCell([&](Cell const& cell) {
+    auto one = remap.GetAverage(cell, [](Cell const&) { return 1.0; });
+    EXPECT_NEAR(one, 1.0, 1e-14);
+    fine_integral += remap.GetAverage(cell, get) * cell.Measure();
+  });
+  EXPECT_NEAR(fine_integral, coarse_integral, 1e-14);
+  // Remapping onto the same mesh changes nothing:
+  coarse->ForEachCell([&](Cell const& cell) {
+    EXPECT_NEAR(remap.GetAverage(cell, get), get(cell), 1e-14);
+  });
+}
+TEST_F(RemapTest, RejectDegenerateSources) {
+  auto empty = Mesh();
+  EXPECT_THROW(Remap{empty}, std::invalid_argument);
+  // All nodes on the x-axis, so the bounding box has no height:
+  auto flat = Mesh();
+  flat.EmplaceNode(0, 0.0, 0.0);
+  flat.EmplaceNode(1, 1.0, 0.0);
+  flat.EmplaceNode(2, 2.0, 0.0);
+  flat.EmplaceCell(0, {0, 1, 2});
+  EXPECT_THROW(Remap{flat}, std::invalid_argument);
+}
+
 }  // namespace mesh
 }  // namespace mini
 
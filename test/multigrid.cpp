@@ -0,0 +1,88 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "mini/model/multigrid.hpp"
+#include "mini/riemann/rotated/single.hpp"
+
+namespace mini {
+namespace model {
+
+class MultigridTest : public ::testing::Test {
+ protected:
+  using Riemann = riemann::rotated::Single;
+  using Multigrid = model::Multigrid<Riemann>;
+  using Face = Multigrid::Face;
+  using Kind = Multigrid::Kind;
+  void SetUp() override {
+    Riemann::global_coefficient = {1.0, 0.0};
+    Riemann::ClearUnrotatedSimples();
+  }
+  // A row of `n` unit squares, whose inlet is solid (i.e. nothing flows in),
+  // and whose outlet is free:
+  static std::vector<Face> GetRow(int n) {
+    auto faces = std::vector<Face>();
+    auto add = [&](int positive, int negative, Kind kind) {
+      auto riemann = Riemann();
+      riemann.Rotate(1.0, 0.0);
+      faces.push_back({riemann, 1.0, 0.0, 1.0, positive, negative, kind});
+    };
+    add(-1, 0, Kind::kSolid);
+    for (int i = 1; i != n; ++i) { add(i - 1, i, Kind::kTwoSided); }
+    add(n - 1, -1, Kind::kFree);
+    return faces;
+  }
+};
+TEST_F(MultigridTest, TestAgglomerate) {
+  auto chain = std::vector<std::pair<int, int>>();
+  for (int i = 1; i != 8; ++i) { chain.emplace_back(i - 1, i); }
+  EXPECT_EQ(Multigrid::Agglomerate(8, chain),
+            (std::vector<int>{0, 0, 1, 1, 2, 2, 3, 3}));
+  // The last cell is left alone, so it joins its neighbor:
+  chain.resize(2);
+  EXPECT_EQ(Multigrid::Agglomerate(3, chain), (std::vector<int>{0, 0, 0}));
+  // A 2 * 2 grid is merged at once:
+  auto grid = std::vector<std::pair<int, int>>{{0, 1}, {0, 2}, {1, 3}, {2, 3}};
+  EXPECT_EQ(Multigrid::Agglomerate(4, grid), (std::vector<int>{0, 0, 0, 0}));
+}
+TEST_F(MultigridTest, TestBuild) {
+  auto multigrid = Multigrid(3, 1, 1);
+  multigrid.Build(std::vector<double>(16, 1.0), GetRow(16));
+  EXPECT_EQ(multigrid.CountLevels(), 3);
+  EXPECT_EQ(multigrid.CountCells(1), 8);
+  EXPECT_EQ(multigrid.CountCells(2), 4);
+  // Interior faces of aggregates are dropped, but boundary faces are kept:
+  EXPECT_EQ(multigrid.CountFaces(0), 17);
+  EXPECT_EQ(multigrid.CountFaces(1), 9);
+  EXPECT_EQ(multigrid.CountFaces(2), 5);
+}
+TEST_F(MultigridTest, TestCycle) {
+  int n = 16;
+  auto states = std::vector<double>(n);
+  for (int i = 0; i != n; ++i) { states[i] = std::sin(i); }
+  for (int gamma : {1, 2}) {
+    auto multigrid = Multigrid(3, gamma, 1);
+    multigrid.Build(std::vector<double>(n, 1.0), GetRow(n));
+    auto u = states;
+    multigrid.Cycle(&u, 0.5);
+    EXPECT_EQ(multigrid.GetConvergenceFactor(), 0.0);
+    for (int k = 1; k != 40; ++k) {
+      multigrid.Cycle(&u, 0.5);
+      EXPECT_LT(multigrid.GetConvergenceFactor(), 1.0);
+    }
+    // The inflow state is swept downstream:
+    for (int i = 0; i != n; ++i) { EXPECT_NEAR(u[i], 0.0, 1e-6); }
+  }
+}
+
+}  // namespace model
+}  // namespace mini
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
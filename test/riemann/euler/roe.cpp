@@ -0,0 +1,97 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "mini/riemann/euler/types.hpp"
+#include "mini/riemann/euler/roe.hpp"
+
+namespace mini {
+namespace riemann {
+namespace euler {
+
+class RoeTest : public ::testing::Test {
+ protected:
+  using Gas = IdealGas<1, 4>;
+  using Solver = Roe<Gas>;
+  using State = Solver::State;
+  using Flux = Solver::Flux;
+  Solver solver;
+  static void CompareFlux(Flux const& lhs, Flux const& rhs) {
+    EXPECT_DOUBLE_EQ(lhs.mass, rhs.mass);
+    EXPECT_DOUBLE_EQ(lhs.energy, rhs.energy);
+    EXPECT_DOUBLE_EQ(lhs.momentum[0], rhs.momentum[0]);
+  }
+};
+TEST_F(RoeTest, TestFlux) {
+  auto rho{0.1}, u{0.2}, p{0.3};
+  auto flux = Flux{rho * u, rho * u * u + p, u};
+  flux.energy *= p * Gas::GammaOverGammaMinusOne() + 0.5 * rho * u * u;
+  EXPECT_EQ(solver.GetFlux({rho, u, p}), flux);
+}
+TEST_F(RoeTest, TestConsistency) {
+  State state{0.5, -0.3, 0.7};
+  CompareFlux(solver.GetFluxOnTimeAxis(state, state), solver.GetFlux(state));
+}
+TEST_F(RoeTest, TestSupersonic) {
+  State left{1.0, 3.0, 1.0}, right{0.5, 3.5, 0.5};
+  CompareFlux(solver.GetFluxOnTimeAxis(left, right), solver.GetFlux(left));
+  left.u() = -3.5, right.u() = -3.0;
+  CompareFlux(solver.GetFluxOnTimeAxis(left, right), solver.GetFlux(right));
+}
+TEST_F(RoeTest, TestShockCollision) {
+  State left{5.99924, 19.5975, 460.894}, right{5.99242, 6.19633, 46.0950};
+  CompareFlux(solver.GetFluxOnTimeAxis(left, right),
+              solver.GetFlux({5.99924, 19.5975, 460.894}));
+}
+TEST_F(RoeTest, TestSod) {
+  State left{1.0, 0.0, 1.0}, right{0.125, 0.0, 0.1};
+  auto flux = solver.GetFluxOnTimeAxis(left, right);
+  auto exact = solver.GetFlux({0.426319, +0.927453, 0.303130});
+  EXPECT_NEAR(flux.mass, exact.mass, 0.01);
+  EXPECT_NEAR(flux.momentum[0], exact.momentum[0], 0.15);
+  EXPECT_NEAR(flux.energy, exact.energy, 0.15);
+}
+
+class Roe2dTest : public ::testing::Test {
+ protected:
+  using Solver = Roe<IdealGas<1, 4>, 2>;
+  using State = Solver::State;
+  using Speed = State::Speed;
+  using Flux = Solver::Flux;
+  Solver solver;
+  Speed v__left{1.5}, v_right{2.5};
+  static void CompareFlux(Flux const& lhs, Flux const& rhs) {
+    EXPECT_DOUBLE_EQ(lhs.mass, rhs.mass);
+    EXPECT_DOUBLE_EQ(lhs.energy, rhs.energy);
+    EXPECT_DOUBLE_EQ(lhs.momentum[0], rhs.momentum[0]);
+    EXPECT_DOUBLE_EQ(lhs.momentum[1], rhs.momentum[1]);
+  }
+};
+TEST_F(Roe2dTest, TestConsistency) {
+  State state{0.5, -0.3, v__left, 0.7};
+  CompareFlux(solver.GetFluxOnTimeAxis(state, state), solver.GetFlux(state));
+}
+TEST_F(Roe2dTest, TestSupersonic) {
+  State  left{1.0, 3.0, v__left, 1.0};
+  State right{0.5, 3.5, v_right, 0.5};
+  CompareFlux(solver.GetFluxOnTimeAxis(left, right), solver.GetFlux(left));
+  left.u() = -3.5, right.u() = -3.0;
+  CompareFlux(solver.GetFluxOnTimeAxis(left, right), solver.GetFlux(right));
+}
+TEST_F(Roe2dTest, TestShockCollision) {
+  State  left{5.99924, 19.5975, v__left, 460.894};
+  State right{5.99242, 6.19633, v_right, 46.0950};
+  CompareFlux(solver.GetFluxOnTimeAxis(left, right),
+              solver.GetFlux({5.99924, 19.5975, v__left, 460.894}));
+}
+
+}  // namespace euler
+}  // namespace riemann
+}  // namespace mini
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
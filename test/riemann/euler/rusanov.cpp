@@ -0,0 +1,92 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "mini/riemann/euler/types.hpp"
+#include "mini/riemann/euler/rusanov.hpp"
+
+namespace mini {
+namespace riemann {
+namespace euler {
+
+class RusanovTest : public ::testing::Test {
+ protected:
+  using Gas = IdealGas<1, 4>;
+  using Solver = Rusanov<Gas>;
+  using State = Solver::State;
+  using Flux = Solver::Flux;
+  Solver solver;
+  static void CompareFlux(Flux const& lhs, Flux const& rhs) {
+    EXPECT_DOUBLE_EQ(lhs.mass, rhs.mass);
+    EXPECT_DOUBLE_EQ(lhs.energy, rhs.energy);
+    EXPECT_DOUBLE_EQ(lhs.momentum[0], rhs.momentum[0]);
+  }
+};
+TEST_F(RusanovTest, TestFlux) {
+  auto rho{0.1}, u{0.2}, p{0.3};
+  auto flux = Flux{rho * u, rho * u * u + p, u};
+  flux.energy *= p * Gas::GammaOverGammaMinusOne() + 0.5 * rho * u * u;
+  EXPECT_EQ(solver.GetFlux({rho, u, p}), flux);
+}
+TEST_F(RusanovTest, TestConsistency) {
+  State state{0.5, -0.3, 0.7};
+  CompareFlux(solver.GetFluxOnTimeAxis(state, state), solver.GetFlux(state));
+}
+TEST_F(RusanovTest, TestSymmetry) {
+  State left{1.0, 0.0, 1.0}, right{0.125, 0.0, 0.1};
+  auto flux = solver.GetFluxOnTimeAxis(left, right);
+  auto mirror = solver.GetFluxOnTimeAxis(right, left);
+  EXPECT_DOUBLE_EQ(flux.mass, -mirror.mass);
+  EXPECT_DOUBLE_EQ(flux.momentum[0], mirror.momentum[0]);
+  EXPECT_DOUBLE_EQ(flux.energy, -mirror.energy);
+}
+TEST_F(RusanovTest, TestSod) {
+  State left{1.0, 0.0, 1.0}, right{0.125, 0.0, 0.1};
+  auto a = std::sqrt(Gas::Gamma());
+  auto speed = std::max(a, std::sqrt(Gas::Gamma() * 0.1 / 0.125));
+  auto flux = solver.GetFluxOnTimeAxis(left, right);
+  EXPECT_DOUBLE_EQ(flux.mass, 0.5 * speed * (1.0 - 0.125));
+  EXPECT_DOUBLE_EQ(flux.momentum[0], 0.5 * (1.0 + 0.1));
+  EXPECT_DOUBLE_EQ(flux.energy,
+                   0.5 * speed * (1.0 - 0.1) * Gas::OneOverGammaMinusOne());
+}
+
+class Rusanov2dTest : public ::testing::Test {
+ protected:
+  using Solver = Rusanov<IdealGas<1, 4>, 2>;
+  using State = Solver::State;
+  using Speed = State::Speed;
+  using Flux = Solver::Flux;
+  Solver solver;
+  Speed v__left{1.5}, v_right{2.5};
+  static void CompareFlux(Flux const& lhs, Flux const& rhs) {
+    EXPECT_DOUBLE_EQ(lhs.mass, rhs.mass);
+    EXPECT_DOUBLE_EQ(lhs.energy, rhs.energy);
+    EXPECT_DOUBLE_EQ(lhs.momentum[0], rhs.momentum[0]);
+    EXPECT_DOUBLE_EQ(lhs.momentum[1], rhs.momentum[1]);
+  }
+};
+TEST_F(Rusanov2dTest, TestConsistency) {
+  State state{0.5, -0.3, v__left, 0.7};
+  CompareFlux(solver.GetFluxOnTimeAxis(state, state), solver.GetFlux(state));
+}
+TEST_F(Rusanov2dTest, TestShear) {
+  State  left{1.0, 0.0, v__left, 1.0};
+  State right{1.0, 0.0, v_right, 1.0};
+  auto speed = std::sqrt(IdealGas<1, 4>::Gamma());
+  auto flux = solver.GetFluxOnTimeAxis(left, right);
+  EXPECT_DOUBLE_EQ(flux.mass, 0.0);
+  EXPECT_DOUBLE_EQ(flux.momentum[0], 1.0);
+  EXPECT_DOUBLE_EQ(flux.momentum[1], -0.5 * speed * (v_right - v__left));
+}
+
+}  // namespace euler
+}  // namespace riemann
+}  // namespace mini
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "mini/riemann/linear/double.hpp"
+#include "mini/riemann/linear/system.hpp"
+
+namespace mini {
+namespace riemann {
+namespace linear {
+
+class SystemTest : public ::testing::Test {
+ protected:
+  using Solver = System<3>;
+  using State = Solver::State;
+  using Flux = Solver::Flux;
+  using Matrix = Solver::Matrix;
+  State left{1.0, 11.0, 3.0}, right{2.0, 22.0, 4.0};
+  static void CompareFlux(Flux const& lhs, Flux const& rhs) {
+    for (int i = 0; i != lhs.size(); ++i) {
+      EXPECT_NEAR(lhs[i], rhs[i], 1e-12);
+    }
+  }
+};
+TEST_F(SystemTest, TestBlockDiagonal) {
+  // eigen_values = {-3, 3, -1}
+  auto solver = Solver(Matrix{{-5.0, 4.0, 0.0},
+                              {-4.0, 5.0, 0.0},
+                              {0.0, 0.0, -1.0}});
+  auto eigen_values = solver.GetEigenValues();
+  EXPECT_NEAR(eigen_values[0], -3.0, 1e-12);
+  EXPECT_NEAR(eigen_values[1], -1.0, 1e-12);
+  EXPECT_NEAR(eigen_values[2], +3.0, 1e-12);
+  auto double_solver = Double(Double::Matrix{{-5.0, 4.0}, {-4.0, 5.0}});
+  auto f_double = double_solver.GetFluxOnTimeAxis({1.0, 11.0}, {2.0, 22.0});
+  CompareFlux(solver.GetFluxOnTimeAxis(left, right),
+              Flux{f_double[0], f_double[1], -1.0 * right[2]});
+}
+TEST_F(SystemTest, TestAcoustics) {
+  // p_t + K * u_x = 0, u_t + p_x / rho = 0, eigen_values = {-c, 0, c}
+  double rho = 1.0, bulk = 4.0, c = 2.0;
+  auto solver = Solver(Matrix{{0.0, bulk, 0.0},
+                              {1 / rho, 0.0, 0.0},
+                              {0.0, 0.0, 0.0}});
+  auto eigen_values = solver.GetEigenValues();
+  EXPECT_NEAR(eigen_values[0], -c, 1e-12);
+  EXPECT_NEAR(eigen_values[1], 0.0, 1e-12);
+  EXPECT_NEAR(eigen_values[2], +c, 1e-12);
+  // The state on t-Axis is the acoustic (p, u) star state:
+  auto z = rho * c;
+  auto p_star = (left[0] + right[0]) / 2 - z * (right[1] - left[1]) / 2;
+  auto u_star = (left[1] + right[1]) / 2 - (right[0] - left[0]) / z / 2;
+  CompareFlux(solver.GetFluxOnTimeAxis(left, right),
+              Flux{bulk * u_star, p_star / rho, 0.0});
+  CompareFlux(solver.GetFluxOnTimeAxis(left, left), solver.GetFlux(left));
+}
+TEST_F(SystemTest, TestRepeatedEigenValues) {
+  // Linearized Euler in 2D, eigen_values = {u - c, u, u, u + c}
+  double rho = 1.0, c = 2.0, u = 0.5, v = 0.3;
+  using Solver = System<4>;
+  auto solver = Solver(Solver::Matrix{{u, rho, 0.0, 0.0},
+                                      {0.0, u, 0.0, 1 / rho},
+                                      {0.0, 0.0, u, 0.0},
+                                      {0.0, rho * c * c, 0.0, u}});
+  auto eigen_values = solver.GetEigenValues();
+  EXPECT_NEAR(eigen_values[0], u - c, 1e-12);
+  EXPECT_NEAR(eigen_values[1], u, 1e-12);
+  EXPECT_NEAR(eigen_values[2], u, 1e-12);
+  EXPECT_NEAR(eigen_values[3], u + c, 1e-12);
+  auto state = Solver::State{1.0, 2.0, 3.0, 4.0};
+  auto flux = solver.GetFluxOnTimeAxis(state, state);
+  auto expect = solver.GetFlux(state);
+  for (int i = 0; i != 4; ++i) {
+    EXPECT_NEAR(flux[i], expect[i], 1e-12);
+  }
+}
+
+}  // namespace linear
+}  // namespace riemann
+}  // namespace mini
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,5 +1,7 @@
 // Copyright 2019 Weicheng Pei and Minghao Yang
 
+#include <cmath>
+#include <limits>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -7,6 +9,7 @@
 #include "mini/riemann/euler/types.hpp"
 #include "mini/riemann/euler/exact.hpp"
 #include "mini/riemann/rotated/euler.hpp"
+#include "mini/model/watchdog.hpp"
 
 namespace mini {
 namespace riemann {
@@ -33,6 +36,42 @@ TEST_F(RotatedEulerTest, TestVectorConverter) {
   EXPECT_DOUBLE_EQ(v[0], v_copy[0]);
   EXPECT_DOUBLE_EQ(v[1], v_copy[1]);
 }
+TEST_F(RotatedEulerTest, TestGhostStates) {
+  Vector n{+0.6, 0.8};
+  solver.Rotate(n);
+  auto inner = State(1.0, 1.0, 0.5, 2.5);
+  EXPECT_EQ(solver.GetStateBehindFreeWall(inner), inner);
+  auto ghost = solver.GetStateBehindSolidWall(inner);
+  EXPECT_EQ(ghost.mass, inner.mass);
+  EXPECT_EQ(ghost.energy, inner.energy);
+  // The normal momentum is flipped, and the tangential one is kept:
+  EXPECT_DOUBLE_EQ(ghost.momentum.Dot(n), -inner.momentum.Dot(n));
+  Vector t{-0.8, 0.6};
+  EXPECT_DOUBLE_EQ(ghost.momentum.Dot(t), inner.momentum.Dot(t));
+  // So the mass flux through a solid wall vanishes:
+  auto flux = solver.GetFluxOnTimeAxis(inner, ghost);
+  EXPECT_NEAR(flux.mass, 0.0, 1e-12);
+}
+TEST_F(RotatedEulerTest, TestAdmissibleStates) {
+  using Watchdog = model::Watchdog<Solver>;
+  auto states = std::vector<State>{
+      State(1.0, 1.0, 0.5, 2.5), State(0.0, 0.0, 0.0, 0.0)};
+  EXPECT_TRUE(Watchdog::AreHealthy(states.data(), states.size()));
+  EXPECT_FALSE(Solver::IsAdmissible(State(-1.0, 0.0, 0.0, 2.5)));
+  EXPECT_FALSE(Solver::IsAdmissible(State(1.0, 3.0, 0.0, 2.5)));  // p < 0
+  states.emplace_back(1.0, std::nan(""), 0.0, 2.5);
+  EXPECT_FALSE(Watchdog::AreHealthy(states.data(), states.size()));
+  states.back() = State(1.0, std::numeric_limits<double>::infinity(), 0.0, 2.5);
+  EXPECT_FALSE(Watchdog::IsHealthy(states.back()));
+  EXPECT_EQ(Watchdog::ToString(states.front()), "[1, 1, 0.5, 2.5]");
+}
+TEST_F(RotatedEulerTest, TestMaximumSpeed) {
+  solver.Rotate(0.6, 0.8);
+  auto left = State(1.0, 3.0, 4.0, 15.0);  // u_n = 5, a = sqrt(1.4)
+  auto right = State(1.4, 0.0, 0.0, 2.5);  // u_n = 0, a = 1
+  EXPECT_DOUBLE_EQ(solver.GetMaximumSpeed(left, right), 5 + std::sqrt(1.4));
+  EXPECT_DOUBLE_EQ(solver.GetMaximumSpeed(right, right), 1.0);
+}
 
 }  // namespace rotated
 }  // namespace riemann
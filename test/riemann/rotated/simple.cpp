@@ -0,0 +1,99 @@
+// Copyright 2019 Weicheng Pei and Minghao Yang
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "mini/riemann/linear/double.hpp"
+#include "mini/riemann/rotated/double.hpp"
+
+namespace mini {
+namespace riemann {
+namespace rotated {
+
+class RotatedDoubleTest : public ::testing::Test {
+ protected:
+  using Solver = Double;
+  using Jacobi = Solver::Jacobi;
+  using State = Solver::State;
+  void SetUp() override {
+    Solver::global_coefficient[0] = Jacobi{{-5.0, 4.0}, {-4.0, 5.0}};
+    Solver::global_coefficient[1] = Jacobi{{-5.0, 4.0}, {-4.0, 5.0}};
+    Solver::ClearUnrotatedSimples();
+  }
+};
+TEST_F(RotatedDoubleTest, TestSharedDecomposition) {
+  static_assert(sizeof(Solver) == 2 * sizeof(int));  // table and index
+  auto a = Solver(), b = Solver(), c = Solver();
+  a.Rotate(0.6, 0.8);
+  b.Rotate(0.6, 0.8 + 1e-15);
+  EXPECT_EQ(Solver::CountUnrotatedSimples(), 1);
+  c.Rotate(1.0, 0.0);
+  EXPECT_EQ(Solver::CountUnrotatedSimples(), 2);
+  State left{1.0, 11.0}, right{2.0, 22.0};
+  auto flux = a.GetFluxOnTimeAxis(left, right);
+  EXPECT_EQ(flux, b.GetFluxOnTimeAxis(left, right));
+  auto unrotated = linear::Double(Jacobi{{-5.0, 4.0}, {-4.0, 5.0}});
+  EXPECT_EQ(c.GetFluxOnTimeAxis(left, right),
+            unrotated.GetFluxOnTimeAxis(left, right));
+}
+TEST_F(RotatedDoubleTest, TestCoexistingCoefficients) {
+  auto a = Solver(), b = Solver();
+  a.Rotate(1.0, 0.0);
+  Solver::global_coefficient[0] = Jacobi{{2.0, 0.0}, {0.0, -3.0}};
+  b.Rotate(1.0, 0.0);
+  EXPECT_EQ(Solver::CountUnrotatedSimples(), 1);  // in a new table
+  // `a` is not affected by the change of `global_coefficient`:
+  State left{1.0, 11.0}, right{2.0, 22.0};
+  auto old_unrotated = linear::Double(Jacobi{{-5.0, 4.0}, {-4.0, 5.0}});
+  EXPECT_EQ(a.GetFluxOnTimeAxis(left, right),
+            old_unrotated.GetFluxOnTimeAxis(left, right));
+  auto new_unrotated = linear::Double(Jacobi{{2.0, 0.0}, {0.0, -3.0}});
+  EXPECT_EQ(b.GetFluxOnTimeAxis(left, right),
+            new_unrotated.GetFluxOnTimeAxis(left, right));
+  // Neither is `b` by clearing the current table:
+  Solver::ClearUnrotatedSimples();
+  EXPECT_EQ(Solver::CountUnrotatedSimples(), 0);
+  EXPECT_EQ(b.GetFluxOnTimeAxis(left, right),
+            new_unrotated.GetFluxOnTimeAxis(left, right));
+}
+TEST_F(RotatedDoubleTest, TestReleasedTables) {
+  {
+    auto a = Solver(), b = Solver(), c = Solver();
+    a.Rotate(1.0, 0.0);
+    auto old_coefficient = Solver::global_coefficient;
+    Solver::global_coefficient[0] = Jacobi{{2.0, 0.0}, {0.0, -3.0}};
+    b.Rotate(1.0, 0.0);
+    EXPECT_EQ(Solver::CountTables(), 2);
+    // The table of an earlier coefficient is reused:
+    Solver::global_coefficient = old_coefficient;
+    c.Rotate(0.0, 1.0);
+    EXPECT_EQ(Solver::CountTables(), 2);
+    EXPECT_EQ(Solver::CountUnrotatedSimples(), 2);
+    // A copy shares the table of its source:
+    auto d = b;
+    b.Rotate(1.0, 0.0);
+    EXPECT_EQ(Solver::CountTables(), 2);
+    d = c;
+    EXPECT_EQ(Solver::CountTables(), 1);
+  }
+  // Tables without walls are freed, except the current one:
+  EXPECT_EQ(Solver::CountTables(), 1);
+  Solver::ClearUnrotatedSimples();
+  EXPECT_EQ(Solver::CountTables(), 0);
+}
+TEST_F(RotatedDoubleTest, TestMaximumSpeed) {
+  auto a = Solver();
+  a.Rotate(1.0, 0.0);  // eigen values are -3 and +3
+  State left{1.0, 11.0}, right{2.0, 22.0};
+  EXPECT_DOUBLE_EQ(a.GetMaximumSpeed(left, right), 3.0);
+}
+
+}  // namespace rotated
+}  // namespace riemann
+}  // namespace mini
+
+int main(int argc, char* argv[]) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}